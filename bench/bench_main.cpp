@@ -0,0 +1,194 @@
+// Microbenchmarks for the simulation hot paths: world update, entity recycling,
+// collision checks, world snapshots and HUD text. Built and run by `make bench`; no window needed.
+//
+// Each benchmark runs at 5, 500 and 50k synthetic entities (recycling also at
+// MAX_STRESS_ENTITIES) and prints ns per operation and operations per second.
+// Compare against a previous run to catch regressions.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "broadphase.hpp"
+#include "collision_kernel.hpp"
+#include "hud_text.hpp"
+#include "level_generator.hpp"
+#include "simulation.hpp"
+#include "world_snapshot.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int ENTITY_COUNTS[] = {5, 500, 50000};
+const double MIN_SECONDS = 0.2; // per measurement
+const int REPEATS = 3;          // best of
+
+// Keeps results alive so the optimizer can't drop the work
+volatile std::size_t sink = 0;
+
+// Runs body(iterations) with growing iteration counts until it takes MIN_SECONDS,
+// and returns the best ns per iteration over REPEATS measurements
+double measure(const std::function<void(long)>& body) {
+    long iterations = 1;
+    double best = 0.0;
+    for (int repeat = 0; repeat < REPEATS; ++repeat) {
+        while (true) {
+            auto start = Clock::now();
+            body(iterations);
+            double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            if (seconds >= MIN_SECONDS) {
+                double ns = seconds * 1e9 / iterations;
+                best = repeat == 0 ? ns : std::min(best, ns);
+                break;
+            }
+            iterations = seconds > 0.01 ? long(iterations * MIN_SECONDS / seconds * 1.1) + 1 : iterations * 10;
+        }
+    }
+    return best;
+}
+
+// unit: what one "item" is for the throughput column (ticks, entities, ...)
+void report(const char* name, int count, double nsPerOp, double itemsPerOp, const char* unit) {
+    double perSecond = itemsPerOp * 1e9 / nsPerOp;
+    std::printf("%-24s %8d %14.1f %16.3e %s/s\n", name, count, nsPerOp, perSecond, unit);
+}
+
+// A world with `count` coins and `count` obstacles that never ends its run
+World makeWorld(int count, LevelMode mode) {
+    World world;
+    world.config.stressEntities = count;
+    world.config.levelMode = mode;
+    resetWorld(world, 42);
+    world.lives = 1 << 30;
+    return world;
+}
+
+void benchWorldUpdate(int count) {
+    for (LevelMode mode : {LevelMode::Streamed, LevelMode::Recycled}) {
+        World world = makeWorld(count, mode);
+        SimInput input;
+        double ns = measure([&](long iterations) {
+            for (long i = 0; i < iterations; ++i) {
+                input.jump = (world.tick % 90) == 0;
+                sink += step(world, input).coinsCollected;
+            }
+        });
+        report(mode == LevelMode::Streamed ? "step (streamed)" : "step (recycled)", count, ns, 1.0, "tick");
+    }
+}
+
+void benchRecycling(int count) {
+    // What recycling costs the broadphase: an entity leaves on the left and
+    // reappears past the rightmost one
+    std::vector<float> x(count), w(count, 40.0f);
+    for (int i = 0; i < count; ++i) x[i] = i * 50.0f;
+    AxisIndex index;
+    index.rebuild(x, w);
+    int next = 0;
+    float rightmost = x.back();
+    double ns = measure([&](long iterations) {
+        for (long i = 0; i < iterations; ++i) {
+            rightmost += 50.0f;
+            index.relocate(next, x[next], rightmost, w[next]);
+            x[next] = rightmost;
+            next = (next + 1) % count;
+        }
+    });
+    report("recycle (index)", count, ns, 1.0, "entity");
+
+    // Streamed level: generating the chunks that refill the freed slots
+    // (count sets how many chunks ahead, as a stand-in for level length)
+    int chunk = 0;
+    ns = measure([&](long iterations) {
+        for (long i = 0; i < iterations; ++i) {
+            sink += generateChunk(42, chunk, 300.0f).platformCount;
+            chunk = (chunk + 1) % count;
+        }
+    });
+    report("recycle (chunk gen)", count, ns, 1.0, "chunk");
+}
+
+void benchCollision(int count) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> xDist(0, WINDOW_WIDTH), yDist(100, GROUND_Y);
+    PackedBounds bounds;
+    for (int i = 0; i < count; ++i) bounds.push(std::uint32_t(i), xDist(rng), yDist(rng), 32.0f, 34.0f);
+    std::vector<std::uint64_t> mask;
+
+    double ns = measure([&](long iterations) {
+        for (long i = 0; i < iterations; ++i) {
+            overlapMask(100.0f, float(300 + i % 50), float(FRAME_WIDTH), float(FRAME_HEIGHT), bounds, mask);
+            sink += mask[0];
+        }
+    });
+    std::string name = std::string("collide (") + collisionKernelName() + ")";
+    report(name.c_str(), count, ns, count, "box");
+
+    ns = measure([&](long iterations) {
+        for (long i = 0; i < iterations; ++i) {
+            overlapMaskScalar(100.0f, float(300 + i % 50), float(FRAME_WIDTH), float(FRAME_HEIGHT), bounds, mask);
+            sink += mask[0];
+        }
+    });
+    report("collide (scalar)", count, ns, count, "box");
+}
+
+void benchSnapshot(int count) {
+    // Practice mode captures every tick and restores on rewind
+    World world = makeWorld(count, LevelMode::Streamed);
+    SimInput input;
+    for (int i = 0; i < 600; ++i) step(world, input);
+    WorldSnapshot snapshot;
+    double ns = measure([&](long iterations) {
+        for (long i = 0; i < iterations; ++i) {
+            captureWorld(world, snapshot);
+            sink += snapshot.world.coins.size();
+        }
+    });
+    report("snapshot (capture)", count, ns, 1.0, "world");
+
+    ns = measure([&](long iterations) {
+        for (long i = 0; i < iterations; ++i) {
+            restoreWorld(world, snapshot);
+            sink += world.coins.size();
+        }
+    });
+    report("snapshot (restore)", count, ns, 1.0, "world");
+}
+
+void benchHud(int count) {
+    // One op updates both HUD values for `count` frames at 60 fps, the way the game
+    // does: time changes once a second, coins every few frames
+    HudCounter time("Time: "), coins("Coins: ");
+    double ns = measure([&](long iterations) {
+        for (long i = 0; i < iterations; ++i) {
+            for (int frame = 0; frame < count; ++frame) {
+                sink += time.set(frame / 60);
+                sink += coins.set(frame / 10);
+            }
+            sink += time.text().size() + coins.text().size();
+        }
+    });
+    report("hud text", count, ns, count, "frame");
+}
+
+} // namespace
+
+int main() {
+    std::printf("%-24s %8s %14s %16s\n", "benchmark", "entities", "ns/op", "throughput");
+    for (int count : ENTITY_COUNTS) {
+        benchWorldUpdate(count);
+        benchRecycling(count);
+        benchCollision(count);
+        benchSnapshot(count);
+        benchHud(count);
+    }
+    // Recycling must not grow with entity count, up to the most --stress allows
+    benchRecycling(MAX_STRESS_ENTITIES);
+    return 0;
+}
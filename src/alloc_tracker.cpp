@@ -0,0 +1,119 @@
+#include "alloc_tracker.hpp"
+
+#include <iostream>
+
+#ifdef ALLOC_TRACKER
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <stdlib.h> // posix_memalign
+
+namespace {
+
+// Trivial type, so it needs no constructor or destructor and is safe to touch from
+// operator new at any point in a thread's life
+thread_local AllocationCounts counts;
+
+void* allocate(std::size_t size) {
+    counts.allocations++;
+    counts.bytes += size;
+    return std::malloc(size > 0 ? size : 1);
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+    counts.allocations++;
+    counts.bytes += size;
+    void* p = nullptr;
+    // posix_memalign wants at least pointer alignment; free() releases it like the rest
+    if (posix_memalign(&p, std::max(std::size_t(alignment), sizeof(void*)), size > 0 ? size : 1) != 0) return nullptr;
+    return p;
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    if (void* p = allocate(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* p = allocate(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (void* p = allocateAligned(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    if (void* p = allocateAligned(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+
+AllocationCounts threadAllocations() {
+    return counts;
+}
+
+#else
+
+AllocationCounts threadAllocations() {
+    return {};
+}
+
+#endif
+
+FrameAllocationCheck::FrameAllocationCheck(bool report_) : report(report_) {}
+
+void FrameAllocationCheck::beginFrame() {
+    endFrame();
+    // The report in endFrame() may allocate itself; start counting the new frame after it
+    frameStart = threadAllocations();
+    frame++;
+    frameOpen = true;
+}
+
+void FrameAllocationCheck::endFrame() {
+    if (!frameOpen) return;
+    frameOpen = false;
+    AllocationCounts now = threadAllocations();
+    lastFrame.allocations = now.allocations - frameStart.allocations;
+    lastFrame.bytes = now.bytes - frameStart.bytes;
+    if (lastFrame.allocations > 0 && frame - lastUnsteadyFrame > WARMUP_FRAMES) {
+        flagged++;
+        if (report && flagged <= MAX_REPORTS) {
+            std::cerr << "Frame " << frame << " allocated " << lastFrame.allocations << " times ("
+                      << lastFrame.bytes << " bytes) in steady state" << std::endl;
+        }
+    }
+}
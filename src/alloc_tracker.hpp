@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+// Heap allocation tracking.
+//
+// Built with ALLOC_TRACKER defined (make alloc-check), alloc_tracker.cpp replaces the
+// global operator new/delete, aligned forms included, with versions that count every
+// allocation per thread before handing it to malloc. FrameAllocationCheck turns the
+// counts into a per-frame check for the main loop. Only C++ allocations are seen, not
+// malloc calls made by C libraries (OpenAL, the graphics driver).
+//
+// In a normal build nothing is replaced and the counts stay at 0.
+
+#ifdef ALLOC_TRACKER
+const bool ALLOCATION_TRACKING = true;
+#else
+const bool ALLOCATION_TRACKING = false;
+#endif
+
+struct AllocationCounts {
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes = 0;
+};
+
+// Totals for the calling thread since it started
+AllocationCounts threadAllocations();
+
+// Flags steady-state frames that allocate.
+//
+// A frame is steady state once nothing has changed for WARMUP_FRAMES frames: call
+// unsteady() when something does (a screen change, a run starting or ending, a debug
+// overlay toggled), since those are allowed to allocate.
+class FrameAllocationCheck {
+public:
+    static constexpr long WARMUP_FRAMES = 120;
+    static constexpr std::uint64_t MAX_REPORTS = 20; // stderr lines; later frames are only counted
+
+    // report: print each flagged frame to stderr
+    explicit FrameAllocationCheck(bool report);
+
+    // Top of each frame: checks the frame that just ended, if endFrame() didn't already
+    void beginFrame();
+    // Checks the current frame now, so whatever runs before the next beginFrame() isn't counted
+    void endFrame();
+    void unsteady() { lastUnsteadyFrame = frame; }
+
+    std::uint64_t lastFrameAllocations() const { return lastFrame.allocations; }
+    std::uint64_t flaggedFrames() const { return flagged; }
+    bool reporting() const { return report; }
+
+private:
+    bool report;
+    long frame = -1;
+    bool frameOpen = false;
+    long lastUnsteadyFrame = 0;
+    AllocationCounts frameStart;
+    AllocationCounts lastFrame;
+    std::uint64_t flagged = 0;
+};
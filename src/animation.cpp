@@ -0,0 +1,105 @@
+#include "animation.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+std::runtime_error parseError(int line, const std::string& message) {
+    return std::runtime_error("animations, line " + std::to_string(line) + ": " + message);
+}
+
+} // namespace
+
+void AnimationLibrary::parse(const std::string& text) {
+    clips.clear();
+    frames.clear();
+    std::istringstream in(text);
+    std::string lineText;
+    int line = 0;
+    while (std::getline(in, lineText)) {
+        line++;
+        std::istringstream fields(lineText);
+        std::string keyword;
+        if (!(fields >> keyword) || keyword[0] == '#') continue;
+
+        if (keyword == "clip") {
+            Clip clip;
+            std::string mode;
+            if (!(fields >> clip.name >> clip.image >> clip.frameSeconds >> mode) || clip.frameSeconds <= 0.0f ||
+                (mode != "loop" && mode != "once")) {
+                throw parseError(line, "expected clip <name> <image> <seconds per frame> loop|once [next]");
+            }
+            clip.loop = mode == "loop";
+            if (!clip.loop) fields >> clip.nextName;
+            clip.first = frames.size();
+            clip.count = 0;
+            clips.push_back(clip);
+        } else if (keyword == "strip" || keyword == "frame") {
+            if (clips.empty()) throw parseError(line, keyword + " before the first clip");
+            float x, y, width, height;
+            if (!(fields >> x >> y >> width >> height)) throw parseError(line, "expected <x> <y> <width> <height>");
+            if (keyword == "strip") {
+                int count;
+                if (!(fields >> count) || count < 1) throw parseError(line, "expected a frame count");
+                for (int i = 0; i < count; ++i) frames.push_back({{x + i * width, y, width, height}, 1.0f});
+            } else {
+                float scaleX = 1.0f;
+                fields >> scaleX;
+                frames.push_back({{x, y, width, height}, scaleX});
+            }
+        } else {
+            throw parseError(line, "unknown keyword " + keyword);
+        }
+        clips.back().count = frames.size() - clips.back().first;
+    }
+
+    for (Clip& clip : clips) {
+        if (clip.count == 0) throw std::runtime_error("animations: clip " + clip.name + " has no frames");
+        clip.duration = clip.count * clip.frameSeconds;
+        if (!clip.nextName.empty()) clip.next = find(clip.nextName);
+    }
+}
+
+void AnimationLibrary::resolve(const TextureAtlas& atlas) {
+    for (const Clip& clip : clips) {
+        const sf::IntRect& image = atlas.getRect(clip.image);
+        for (std::size_t i = clip.first; i < clip.first + clip.count; ++i) {
+            frames[i].textureRect.left += float(image.left);
+            frames[i].textureRect.top += float(image.top);
+        }
+    }
+}
+
+std::size_t AnimationLibrary::find(const std::string& name) const {
+    for (std::size_t i = 0; i < clips.size(); ++i) {
+        if (clips[i].name == name) return i;
+    }
+    throw std::runtime_error("animations: no clip named " + name);
+}
+
+const AnimationFrame& AnimationLibrary::frame(std::size_t c, float seconds) const {
+    const Clip* clip = &clips[c];
+    // A finished one-shot hands over to its follow-up (short chains, like land -> run)
+    while (!clip->loop && clip->next != NO_CLIP && seconds >= clip->duration) {
+        seconds -= clip->duration;
+        clip = &clips[clip->next];
+    }
+    std::size_t step = std::size_t(std::max(0.0f, seconds) / clip->frameSeconds);
+    step = clip->loop ? step % clip->count : std::min(step, clip->count - 1);
+    return frames[clip->first + step];
+}
+
+std::size_t AnimationSet::add(std::size_t clip_, float start_) {
+    clip.push_back(clip_);
+    start.push_back(start_);
+    frame.push_back(nullptr);
+    return clip.size() - 1;
+}
+
+void AnimationSet::update(const AnimationLibrary& library, float now) {
+    for (std::size_t i = 0; i < clip.size(); ++i) {
+        frame[i] = &library.frame(clip[i], now - start[i]);
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "texture_atlas.hpp"
+
+// Sprite animation clips, defined in a text file (assets/animations.txt):
+//
+//   clip <name> <atlas image> <seconds per frame> loop
+//   clip <name> <atlas image> <seconds per frame> once [<clip to play after it>]
+//   strip <x> <y> <width> <height> <count>      count frames left to right from (x, y)
+//   frame <x> <y> <width> <height> [x-scale]    one frame, drawn x-scale times as wide, centred
+//
+// A clip's frames follow its clip line; coordinates are pixels in the image as packed into
+// the atlas. Blank lines and lines starting with # are skipped.
+//
+// Every frame's atlas rect is worked out once, when the library is resolved against the
+// atlas, so a frame at draw time is just an index into a table.
+
+struct AnimationFrame {
+    sf::FloatRect textureRect; // in the atlas texture
+    float scaleX = 1.0f;
+};
+
+class AnimationLibrary {
+public:
+    static const std::size_t NO_CLIP = std::size_t(-1);
+
+    // Parses definitions; throws std::runtime_error naming the line on anything malformed
+    void parse(const std::string& text);
+    // Turns the image coordinates into atlas rects (after atlas.pack())
+    void resolve(const TextureAtlas& atlas);
+
+    // Throws std::runtime_error if there is no such clip
+    std::size_t find(const std::string& name) const;
+
+    // The frame shown seconds after the clip started. A one-shot clip holds its last frame
+    // when it is done, or carries on into its follow-up clip if it has one.
+    const AnimationFrame& frame(std::size_t clip, float seconds) const;
+
+private:
+    struct Clip {
+        std::string name, image, nextName;
+        float frameSeconds;
+        bool loop;
+        std::size_t first, count; // in frames
+        std::size_t next = NO_CLIP;
+        float duration;           // count * frameSeconds
+    };
+    std::vector<Clip> clips;
+    std::vector<AnimationFrame> frames; // every clip's frames, back to back
+};
+
+// Animated things, sampled together once per frame. Struct-of-arrays like EntityArrays:
+// entry i plays clip[i], started at start[i] (in the same seconds as update()'s now).
+// Things that animate in step (all coins, all obstacles of a type) share one entry.
+struct AnimationSet {
+    std::vector<std::size_t> clip;
+    std::vector<float> start;
+    std::vector<const AnimationFrame*> frame; // filled by update()
+
+    std::size_t add(std::size_t clip_, float start_ = 0.0f);
+    void update(const AnimationLibrary& library, float now);
+};
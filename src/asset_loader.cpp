@@ -0,0 +1,89 @@
+#include "asset_loader.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+void decodeImage(const AssetPack& pack, const std::string& name, sf::Image& image, const std::string& what) {
+    AssetData file = pack.get(name);
+    if (!image.loadFromMemory(file.data, file.size)) {
+        throw std::runtime_error("Failed to load " + what + "!");
+    }
+}
+
+void decodeSound(const AssetPack& pack, const std::string& name, sf::SoundBuffer& buffer, const std::string& what) {
+    AssetData file = pack.get(name);
+    if (!buffer.loadFromMemory(file.data, file.size)) {
+        throw std::runtime_error("Failed to load " + what + "!");
+    }
+}
+
+} // namespace
+
+AssetLoader::AssetLoader(const AssetPack& pack_) : pack(pack_) {
+    launch([this] { decodeImage(pack, "player_spritesheet.png", assets.player, "player sprite sheet"); });
+    launch([this] { decodeImage(pack, "cloud.png", assets.cloud, "cloud texture"); });
+    launch([this] { decodeImage(pack, "platform.png", assets.platform, "platform texture"); });
+    launch([this] { decodeImage(pack, "coin.png", assets.coin, "coin texture"); });
+    launch([this] { decodeImage(pack, "obstacle1.png", assets.obstacle1, "obstacle1 texture"); });
+    launch([this] { decodeImage(pack, "obstacle2.png", assets.obstacle2, "obstacle2 texture"); });
+    launch([this] { decodeImage(pack, "life.png", assets.life, "life texture"); });
+    launch([this] { decodeImage(pack, "background.jpg", assets.background, "background image"); });
+    launch([this] { decodeImage(pack, "ground.png", assets.ground, "ground texture"); });
+    launch([this] {
+        // The logo is optional
+        if (!pack.contains("logo.png")) return;
+        AssetData file = pack.get("logo.png");
+        assets.logoLoaded = assets.logo.loadFromMemory(file.data, file.size);
+    });
+    launch([this] { decodeSound(pack, "coin.wav", assets.coinBuffer, "coin sound"); });
+    launch([this] { decodeSound(pack, "obs.wav", assets.obsBuffer, "obstacle sound"); });
+    launch([this] { decodeSound(pack, "gameover.wav", assets.gameOverBuffer, "game over sound"); });
+    launch([this] {
+        AssetData file = pack.get("animations.txt");
+        assets.animations.assign(static_cast<const char*>(file.data), file.size);
+    });
+    launch([this] {
+        // sf::Font keeps reading from this memory, which the pack keeps alive
+        AssetData file = pack.get("arial.ttf");
+        if (!assets.font.loadFromMemory(file.data, file.size)) {
+            throw std::runtime_error("Failed to load font!");
+        }
+    });
+}
+
+AssetLoader::~AssetLoader() {
+    // Jobs write into assets, so they must finish before it goes away
+    for (auto& job : jobs) {
+        if (job.valid()) job.wait();
+    }
+}
+
+template <typename Job>
+void AssetLoader::launch(Job job) {
+    jobs.push_back(std::async(std::launch::async, [this, job] {
+        try {
+            job();
+        } catch (...) {
+            finished++;
+            throw;
+        }
+        finished++;
+    }));
+}
+
+float AssetLoader::progress() const {
+    return jobs.empty() ? 1.0f : float(finished.load()) / float(jobs.size());
+}
+
+bool AssetLoader::isDone() const {
+    return finished.load() == int(jobs.size());
+}
+
+LoadedAssets& AssetLoader::get() {
+    for (auto& job : jobs) {
+        if (job.valid()) job.get();
+    }
+    return assets;
+}
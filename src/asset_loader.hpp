@@ -0,0 +1,46 @@
+#pragma once
+
+#include <SFML/Audio.hpp>
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "asset_pack.hpp"
+
+// Everything decoded at startup. Images still need uploading to textures on the main thread.
+struct LoadedAssets {
+    sf::Image player, cloud, platform, coin, obstacle1, obstacle2, life;
+    sf::Image background, ground, logo;
+    bool logoLoaded = false;
+    sf::SoundBuffer coinBuffer, obsBuffer, gameOverBuffer;
+    sf::Font font;
+    std::string animations; // clip definitions, see animation.hpp
+};
+
+// Decodes the startup assets on worker threads, so the main thread can keep
+// drawing a loading screen. Decoding reads straight from the AssetPack's memory.
+class AssetLoader {
+public:
+    explicit AssetLoader(const AssetPack& pack);
+    ~AssetLoader();
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // Fraction of decode jobs finished, 0 to 1
+    float progress() const;
+    bool isDone() const;
+
+    // Waits for all jobs; rethrows the first load error (std::runtime_error)
+    LoadedAssets& get();
+
+private:
+    template <typename Job>
+    void launch(Job job);
+
+    const AssetPack& pack;
+    LoadedAssets assets;
+    std::vector<std::future<void>> jobs;
+    std::atomic<int> finished{0};
+};
@@ -0,0 +1,112 @@
+#include "asset_pack.hpp"
+
+#include <cstdint>
+#include <cstring> //For memcpy
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "asset_pack_format.hpp"
+
+namespace {
+
+template <typename T>
+bool readValue(const char*& cursor, const char* end, T& value) {
+    if (std::size_t(end - cursor) < sizeof(T)) return false;
+    std::memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return true;
+}
+
+} // namespace
+
+AssetPack::~AssetPack() {
+    close();
+}
+
+void AssetPack::close() {
+    if (mapping) munmap(mapping, mappingSize);
+    mapping = nullptr;
+    mappingSize = 0;
+    index.clear();
+}
+
+bool AssetPack::open(const std::string& packPath, const std::string& fallbackDirectory_) {
+    close();
+    fallbackDirectory = fallbackDirectory_;
+
+    int fd = ::open(packPath.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    mappingSize = std::size_t(info.st_size);
+    void* mapped = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps the file alive
+    if (mapped == MAP_FAILED) {
+        mappingSize = 0;
+        return false;
+    }
+    mapping = mapped;
+
+    // Parse the index; anything malformed means we don't trust the pack at all
+    const char* begin = static_cast<const char*>(mapping);
+    const char* end = begin + mappingSize;
+    const char* cursor = begin;
+    char magic[4];
+    std::uint32_t version = 0, entryCount = 0;
+    bool valid = readValue(cursor, end, magic) && std::memcmp(magic, PACK_MAGIC, 4) == 0 &&
+                 readValue(cursor, end, version) && version == PACK_VERSION &&
+                 readValue(cursor, end, entryCount);
+    for (std::uint32_t i = 0; valid && i < entryCount; ++i) {
+        std::uint64_t offset = 0, size = 0;
+        std::uint16_t nameLength = 0;
+        valid = readValue(cursor, end, offset) && readValue(cursor, end, size) &&
+                readValue(cursor, end, nameLength) && std::size_t(end - cursor) >= nameLength &&
+                offset <= mappingSize && size <= mappingSize - offset;
+        if (valid) {
+            index[std::string(cursor, nameLength)] = {begin + offset, std::size_t(size)};
+            cursor += nameLength;
+        }
+    }
+    if (!valid) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool AssetPack::contains(const std::string& name) const {
+    if (mapping) return index.count(name) > 0;
+    std::ifstream file(fallbackDirectory + "/" + name, std::ios::binary);
+    return file.good();
+}
+
+AssetData AssetPack::get(const std::string& name) const {
+    if (mapping) {
+        auto it = index.find(name);
+        if (it == index.end()) {
+            throw std::runtime_error("Asset " + name + " is not in the asset pack!");
+        }
+        return it->second;
+    }
+
+    // Loose files: read once and keep the buffer, so callers can hold on to the pointer
+    std::lock_guard<std::mutex> lock(looseMutex);
+    auto it = looseFiles.find(name);
+    if (it == looseFiles.end()) {
+        std::ifstream file(fallbackDirectory + "/" + name, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Failed to open " + fallbackDirectory + "/" + name + "!");
+        }
+        std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        it = looseFiles.emplace(name, std::move(bytes)).first;
+    }
+    return {it->second.data(), it->second.size()};
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct AssetData {
+    const void* data = nullptr;
+    std::size_t size = 0;
+};
+
+// Read-only access to the game's assets.
+//
+// Normally this memory-maps assets.pak and hands out pointers straight into the mapping,
+// so loadFromMemory/openFromMemory read the file with no extra copies. Without a pack it
+// falls back to reading loose files from the assets directory.
+// The returned bytes stay valid for as long as the AssetPack lives; get() is thread-safe.
+class AssetPack {
+public:
+    AssetPack() = default;
+    ~AssetPack();
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    // Maps the pack file. Returns false (and uses loose files) if it is missing or invalid.
+    bool open(const std::string& packPath, const std::string& fallbackDirectory = "assets");
+
+    bool isMapped() const { return mapping != nullptr; }
+    bool contains(const std::string& name) const;
+
+    // Throws std::runtime_error if the asset doesn't exist
+    AssetData get(const std::string& name) const;
+
+private:
+    void close();
+
+    void* mapping = nullptr;
+    std::size_t mappingSize = 0;
+    std::unordered_map<std::string, AssetData> index;
+
+    std::string fallbackDirectory = "assets";
+    mutable std::mutex looseMutex;
+    mutable std::unordered_map<std::string, std::vector<char>> looseFiles;
+};
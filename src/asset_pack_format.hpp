@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+
+// On-disk layout of assets.pak, shared by the game and tools/pack_assets.cpp.
+// All integers are little-endian.
+//
+//   header  : magic "JDPK", uint32 version, uint32 entry count
+//   index   : per entry uint64 offset, uint64 size, uint16 name length, name bytes
+//   data    : the files, each starting on a PACK_ALIGNMENT boundary
+
+const char PACK_MAGIC[4] = {'J', 'D', 'P', 'K'};
+const std::uint32_t PACK_VERSION = 1;
+const std::uint64_t PACK_ALIGNMENT = 16;
@@ -0,0 +1,207 @@
+#include "batch_runner.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include "headless.hpp"
+
+namespace {
+
+const std::size_t MAX_HISTOGRAM_BUCKETS = 50;
+
+struct RunResult {
+    float survival = 0.0f; // seconds
+    int coins = 0;
+    bool capped = false;   // still alive at maxRunSeconds
+};
+
+struct DifficultyField {
+    const char* name;
+    float DifficultyParams::*value;
+};
+
+const DifficultyField DIFFICULTY_FIELDS[] = {
+    {"speed_step_seconds", &DifficultyParams::speedStepSeconds},
+    {"speed_step", &DifficultyParams::speedStep},
+    {"max_speed", &DifficultyParams::maxSpeed},
+    {"obstacle_start", &DifficultyParams::obstacleStartSeconds},
+    {"hit_cooldown", &DifficultyParams::hitCooldownSeconds},
+};
+
+RunResult playRun(World& world, const SimConfig& config, unsigned int seed, float maxRunSeconds) {
+    world.config = config;
+    resetWorld(world, seed);
+    const long maxTicks = long(maxRunSeconds / config.tickSeconds);
+    while (!world.gameOver && world.tick < maxTicks) step(world, botInput(world));
+
+    RunResult result;
+    result.survival = world.gameEndTime;
+    result.coins = world.coinCount;
+    result.capped = !world.gameOver;
+    return result;
+}
+
+// Nearest-rank percentile of sorted values
+float percentile(const std::vector<float>& sorted, float p) {
+    std::size_t index = std::size_t(std::ceil(p / 100.0f * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, index > 0 ? index - 1 : 0)];
+}
+
+void printDistribution(const char* label, std::vector<float> values) {
+    std::sort(values.begin(), values.end());
+    double sum = 0.0, squares = 0.0;
+    for (float v : values) sum += v;
+    double mean = sum / values.size();
+    for (float v : values) squares += (v - mean) * (v - mean);
+    double stddev = values.size() > 1 ? std::sqrt(squares / (values.size() - 1)) : 0.0;
+
+    std::ostringstream line;
+    line << "  " << std::left << std::setw(10) << label << std::right << std::fixed << std::setprecision(1)
+         << "mean " << mean << "  sd " << stddev << "  min " << values.front() << "  p10 "
+         << percentile(values, 10) << "  p25 " << percentile(values, 25) << "  p50 " << percentile(values, 50)
+         << "  p75 " << percentile(values, 75) << "  p90 " << percentile(values, 90) << "  max "
+         << values.back() << "\n";
+    std::cout << line.str();
+}
+
+// Share of runs ending in each survival bucket. Buckets are bucketSeconds wide (one speed
+// step), widened to whole seconds when that would make more than MAX_HISTOGRAM_BUCKETS.
+// Empty buckets aren't printed.
+void printHistogram(const std::vector<RunResult>& runs, float bucketSeconds) {
+    float longest = 0.0f;
+    for (const RunResult& run : runs) longest = std::max(longest, run.survival);
+    const float width = std::max(bucketSeconds, std::ceil(longest / float(MAX_HISTOGRAM_BUCKETS)));
+
+    std::vector<int> buckets(MAX_HISTOGRAM_BUCKETS, 0);
+    for (const RunResult& run : runs) {
+        buckets[std::min(std::size_t(run.survival / width), MAX_HISTOGRAM_BUCKETS - 1)]++;
+    }
+    std::cout << "  survival  ";
+    bool first = true;
+    for (std::size_t i = 0; i < buckets.size(); ++i) {
+        if (buckets[i] == 0) continue;
+        std::cout << (first ? "" : ", ") << i * width << '-' << (i + 1) * width << " s "
+                  << std::lround(100.0 * buckets[i] / runs.size()) << '%';
+        first = false;
+    }
+    std::cout << "\n";
+}
+
+} // namespace
+
+void parseDifficulty(const std::string& spec, DifficultyParams& params) {
+    std::istringstream words(spec);
+    std::string word;
+    while (words >> word) {
+        std::size_t equals = word.find('=');
+        std::string name = word.substr(0, equals);
+        const DifficultyField* field = nullptr;
+        for (const DifficultyField& f : DIFFICULTY_FIELDS) {
+            if (name == f.name) field = &f;
+        }
+        if (equals == std::string::npos || !field) throw std::runtime_error("Unknown difficulty setting " + word);
+
+        float value;
+        try {
+            value = std::stof(word.substr(equals + 1));
+        } catch (const std::exception&) {
+            throw std::runtime_error("Bad difficulty value " + word);
+        }
+        if (!(value >= 0.0f) || (field->value == &DifficultyParams::speedStepSeconds && value <= 0.0f)) {
+            throw std::runtime_error("Difficulty value out of range: " + word);
+        }
+        params.*(field->value) = value;
+    }
+}
+
+std::string formatDifficulty(const DifficultyParams& params) {
+    std::ostringstream out;
+    for (const DifficultyField& f : DIFFICULTY_FIELDS) {
+        if (&f != DIFFICULTY_FIELDS) out << ' ';
+        out << f.name << '=' << params.*(f.value);
+    }
+    return out.str();
+}
+
+std::vector<DifficultyParams> loadDifficultySets(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) throw std::runtime_error("Failed to open difficulty sets " + path);
+    std::vector<DifficultyParams> sets;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+        DifficultyParams params;
+        parseDifficulty(line, params);
+        sets.push_back(params);
+    }
+    if (sets.empty()) throw std::runtime_error(path + " has no difficulty sets");
+    return sets;
+}
+
+int runBatch(const std::vector<DifficultyParams>& sets, const SimConfig& config, const BatchOptions& options) {
+    const std::size_t runsPerSet = std::size_t(std::max(1, options.runsPerSet));
+    const std::size_t jobCount = sets.size() * runsPerSet;
+    std::vector<RunResult> results(jobCount);
+
+    // Every worker takes the next run until none are left; each writes only its own results
+    std::atomic<std::size_t> nextJob{0};
+    auto worker = [&]() {
+        World world;
+        for (std::size_t job = nextJob++; job < jobCount; job = nextJob++) {
+            SimConfig runConfig = config;
+            runConfig.difficulty = sets[job / runsPerSet];
+            unsigned int seed = options.seed + unsigned(job % runsPerSet);
+            results[job] = playRun(world, runConfig, seed, options.maxRunSeconds);
+        }
+    };
+    unsigned int threadCount = options.threads > 0 ? unsigned(options.threads) : std::thread::hardware_concurrency();
+    threadCount = std::max(1u, threadCount);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < threadCount; ++i) threads.emplace_back(worker);
+    for (std::thread& thread : threads) thread.join();
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Played " << jobCount << " runs (" << sets.size() << " sets x " << runsPerSet << ") on "
+              << threadCount << " threads in " << wallSeconds << " s, seeds from " << options.seed << "\n";
+    for (std::size_t s = 0; s < sets.size(); ++s) {
+        std::vector<RunResult> runs(results.begin() + s * runsPerSet, results.begin() + (s + 1) * runsPerSet);
+        std::vector<float> survival, coins;
+        std::size_t capped = 0;
+        for (const RunResult& run : runs) {
+            survival.push_back(run.survival);
+            coins.push_back(float(run.coins));
+            if (run.capped) capped++;
+        }
+        std::cout << "\nSet " << s + 1 << ": " << formatDifficulty(sets[s]) << "\n";
+        printDistribution("survival", survival);
+        printDistribution("coins", coins);
+        printHistogram(runs, sets[s].speedStepSeconds);
+        if (capped > 0) {
+            std::cout << "  " << capped << " runs still alive at " << options.maxRunSeconds << " s\n";
+        }
+    }
+
+    if (!options.csvPath.empty()) {
+        std::ofstream csv(options.csvPath);
+        csv << "set,seed,survival_s,coins,capped\n";
+        for (std::size_t job = 0; job < jobCount; ++job) {
+            csv << job / runsPerSet + 1 << ',' << options.seed + unsigned(job % runsPerSet) << ','
+                << results[job].survival << ',' << results[job].coins << ',' << (results[job].capped ? 1 : 0) << '\n';
+        }
+        if (!csv) {
+            std::cerr << "Failed to write " << options.csvPath << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "simulation.hpp"
+
+// Difficulty tuning without play-testing.
+//
+// Plays many runs with the scripted bot (botInput in headless.hpp) for each difficulty
+// parameter set, spread over every CPU core, and prints the survival time and coin
+// distributions per set. Run i of every set uses the same level seed, so differences
+// between sets come from the parameters, not the levels. Results don't depend on the
+// number of threads.
+
+struct BatchOptions {
+    int runsPerSet = 1000;
+    unsigned int seed = 0;        // run i uses seed + i
+    float maxRunSeconds = 600.0f; // runs still going by then are stopped and counted at this time
+    std::string csvPath;          // optional: one row per run, for plotting elsewhere
+    int threads = 0;              // 0 = one per core
+};
+
+// Parses "name=value ..." onto params. Names: speed_step_seconds, speed_step, max_speed,
+// obstacle_start, hit_cooldown; names left out keep their value.
+// Throws std::runtime_error on an unknown name or a bad value.
+void parseDifficulty(const std::string& spec, DifficultyParams& params);
+std::string formatDifficulty(const DifficultyParams& params);
+
+// One parameter set per line, in parseDifficulty's format, starting from the defaults.
+// Blank lines and lines starting with # are skipped. Throws std::runtime_error.
+std::vector<DifficultyParams> loadDifficultySets(const std::string& path);
+
+// Returns 0, or 1 if the CSV can't be written
+int runBatch(const std::vector<DifficultyParams>& sets, const SimConfig& config, const BatchOptions& options);
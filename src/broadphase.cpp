@@ -0,0 +1,93 @@
+#include "broadphase.hpp"
+
+namespace {
+
+std::size_t slotsFor(std::size_t n) {
+    std::size_t slots = 16;
+    while (slots < n) slots *= 2;
+    return slots;
+}
+
+} // namespace
+
+void AxisIndex::rebuild(const std::vector<float>& x, const std::vector<float>& w) {
+    offset = 0.0;
+    maxWidth = 0.0f;
+    head = 0;
+    count = x.size();
+    if (ring.size() < count) ring.resize(slotsFor(count));
+    for (std::size_t i = 0; i < count; ++i) {
+        ring[i] = {x[i], std::uint32_t(i)};
+        maxWidth = std::max(maxWidth, w[i]);
+    }
+    std::sort(ring.begin(), ring.begin() + count, [](const Key& a, const Key& b) { return a.x < b.x; });
+}
+
+std::size_t AxisIndex::lowerBound(double value) const {
+    std::size_t low = 0, high = count;
+    while (low < high) {
+        std::size_t middle = low + (high - low) / 2;
+        if (at(middle).x < value) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+std::size_t AxisIndex::upperBound(double value) const {
+    std::size_t low = 0, high = count;
+    while (low < high) {
+        std::size_t middle = low + (high - low) / 2;
+        if (!(value < at(middle).x)) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+void AxisIndex::relocate(std::size_t i, float oldX, float newX, float w) {
+    // Find the entity's key near its old position (it is usually the very first one)
+    std::size_t k = lowerBound(oldX + offset - SLACK);
+    while (k < count && at(k).entity != i) ++k;
+    if (k < count) eraseAt(k);
+
+    // Insert at its new position (usually the very end)
+    Key moved = {newX + offset, std::uint32_t(i)};
+    insertAt(upperBound(moved.x), moved);
+    maxWidth = std::max(maxWidth, w);
+}
+
+void AxisIndex::eraseAt(std::size_t k) {
+    // Close the gap from whichever end is nearer
+    if (k < count / 2) {
+        for (std::size_t j = k; j > 0; --j) at(j) = at(j - 1);
+        head = (head + 1) & (ring.size() - 1);
+    } else {
+        for (std::size_t j = k; j + 1 < count; ++j) at(j) = at(j + 1);
+    }
+    count--;
+}
+
+void AxisIndex::insertAt(std::size_t k, const Key& key) {
+    if (count == ring.size()) grow(slotsFor(count + 1));
+    // Open the gap from whichever end is nearer
+    if (k < count / 2) {
+        head = (head - 1) & (ring.size() - 1);
+        for (std::size_t j = 0; j < k; ++j) at(j) = at(j + 1);
+    } else {
+        for (std::size_t j = count; j > k; --j) at(j) = at(j - 1);
+    }
+    at(k) = key;
+    count++;
+}
+
+void AxisIndex::grow(std::size_t slots) {
+    // Unwrap so the keys start at slot 0; the new slots then go after the last one
+    std::rotate(ring.begin(), ring.begin() + head, ring.end());
+    head = 0;
+    ring.resize(slots);
+}
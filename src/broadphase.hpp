@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Broadphase for the scrolling world: a 1D sweep-and-prune index along x.
+//
+// Keeps one archetype's entities sorted by left edge, so a query binary-searches to
+// the player's x-range and only visits the entities there, instead of all of them.
+//
+// Keys are stored in "track" space (screen x plus how far the archetype has scrolled),
+// so scrolling is one addition and the index only changes when an entity is recycled.
+// Recycled entities leave at the far left and go to the far right, so the sorted keys
+// live in a ring: taking one off the front and adding one at the back moves no other
+// key, whatever the entity count.
+class AxisIndex {
+public:
+    // Rebuilds from scratch; call whenever entities were added, removed or placed.
+    void rebuild(const std::vector<float>& x, const std::vector<float>& w);
+
+    std::size_t size() const { return count; }
+    std::size_t capacity() const { return ring.capacity(); }
+    void reserve(std::size_t n) { ring.reserve(n); }
+
+    // Every entity moved left by dx
+    void scroll(float dx) { offset += dx; }
+
+    // Entity i was teleported from oldX to newX (screen space); w is its width now,
+    // which may be wider than anything seen at the last rebuild when a slot is reused
+    void relocate(std::size_t i, float oldX, float newX, float w);
+
+    // Calls visit(i) for each entity i whose [x, x + w] may overlap [minX, maxX], in x order.
+    // May include a near miss or two, so follow up with the exact AABB test.
+    template <typename Visit>
+    void query(float minX, float maxX, Visit visit) const {
+        const double first = minX + offset - maxWidth - SLACK;
+        const double last = maxX + offset + SLACK;
+        for (std::size_t k = lowerBound(first); k < count && at(k).x <= last; ++k) {
+            visit(std::size_t(at(k).entity));
+        }
+    }
+
+private:
+    // Entity x is updated by repeated float subtraction, so it drifts a hair from the key
+    static constexpr double SLACK = 1.0;
+
+    struct Key {
+        double x; // track-space left edge
+        std::uint32_t entity;
+    };
+
+    // Key k in x order
+    Key& at(std::size_t k) { return ring[(head + k) & (ring.size() - 1)]; }
+    const Key& at(std::size_t k) const { return ring[(head + k) & (ring.size() - 1)]; }
+
+    // First key with x >= value / x > value
+    std::size_t lowerBound(double value) const;
+    std::size_t upperBound(double value) const;
+
+    void eraseAt(std::size_t k);
+    void insertAt(std::size_t k, const Key& key);
+    void grow(std::size_t slots);
+
+    std::vector<Key> ring; // size is a power of two (or 0); count keys from head, sorted by x
+    std::size_t head = 0;
+    std::size_t count = 0;
+    double offset = 0.0;   // distance scrolled since the last rebuild
+    float maxWidth = 0.0f; // widest entity, so queries catch ones starting left of minX
+};
@@ -0,0 +1,89 @@
+#include "collision_kernel.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define COLLISION_KERNEL_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define COLLISION_KERNEL_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define COLLISION_KERNEL_NEON 1
+#endif
+
+namespace {
+
+// Scalar test for candidates [first, count), the tail the SIMD loop didn't cover
+void overlapTail(float left, float top, float right, float bottom,
+                 const PackedBounds& b, std::size_t first, std::uint64_t* mask) {
+    for (std::size_t i = first; i < b.size(); ++i) {
+        bool hit = left < b.right[i] && b.left[i] < right && top < b.bottom[i] && b.top[i] < bottom;
+        if (hit) mask[i / 64] |= std::uint64_t(1) << (i % 64);
+    }
+}
+
+} // namespace
+
+void overlapMaskScalar(float left, float top, float width, float height,
+                       const PackedBounds& bounds, std::vector<std::uint64_t>& mask) {
+    mask.assign((bounds.size() + 63) / 64, 0);
+    overlapTail(left, top, left + width, top + height, bounds, 0, mask.data());
+}
+
+void overlapMask(float left, float top, float width, float height,
+                 const PackedBounds& bounds, std::vector<std::uint64_t>& mask) {
+    mask.assign((bounds.size() + 63) / 64, 0);
+    const float right = left + width, bottom = top + height;
+    const std::size_t n = bounds.size();
+    std::uint64_t* out = mask.data();
+    std::size_t i = 0;
+
+#if COLLISION_KERNEL_AVX2
+    const __m256 l = _mm256_set1_ps(left), t = _mm256_set1_ps(top);
+    const __m256 r = _mm256_set1_ps(right), b = _mm256_set1_ps(bottom);
+    for (; i + 8 <= n; i += 8) {
+        __m256 hit = _mm256_and_ps(
+            _mm256_and_ps(_mm256_cmp_ps(l, _mm256_loadu_ps(&bounds.right[i]), _CMP_LT_OQ),
+                          _mm256_cmp_ps(_mm256_loadu_ps(&bounds.left[i]), r, _CMP_LT_OQ)),
+            _mm256_and_ps(_mm256_cmp_ps(t, _mm256_loadu_ps(&bounds.bottom[i]), _CMP_LT_OQ),
+                          _mm256_cmp_ps(_mm256_loadu_ps(&bounds.top[i]), b, _CMP_LT_OQ)));
+        out[i / 64] |= std::uint64_t(_mm256_movemask_ps(hit)) << (i % 64);
+    }
+#elif COLLISION_KERNEL_SSE2
+    const __m128 l = _mm_set1_ps(left), t = _mm_set1_ps(top);
+    const __m128 r = _mm_set1_ps(right), b = _mm_set1_ps(bottom);
+    for (; i + 4 <= n; i += 4) {
+        __m128 hit = _mm_and_ps(
+            _mm_and_ps(_mm_cmplt_ps(l, _mm_loadu_ps(&bounds.right[i])),
+                       _mm_cmplt_ps(_mm_loadu_ps(&bounds.left[i]), r)),
+            _mm_and_ps(_mm_cmplt_ps(t, _mm_loadu_ps(&bounds.bottom[i])),
+                       _mm_cmplt_ps(_mm_loadu_ps(&bounds.top[i]), b)));
+        out[i / 64] |= std::uint64_t(_mm_movemask_ps(hit)) << (i % 64);
+    }
+#elif COLLISION_KERNEL_NEON
+    const float32x4_t l = vdupq_n_f32(left), t = vdupq_n_f32(top);
+    const float32x4_t r = vdupq_n_f32(right), b = vdupq_n_f32(bottom);
+    const uint32x4_t lanes = {1, 2, 4, 8};
+    for (; i + 4 <= n; i += 4) {
+        uint32x4_t hit = vandq_u32(
+            vandq_u32(vcltq_f32(l, vld1q_f32(&bounds.right[i])), vcltq_f32(vld1q_f32(&bounds.left[i]), r)),
+            vandq_u32(vcltq_f32(t, vld1q_f32(&bounds.bottom[i])), vcltq_f32(vld1q_f32(&bounds.top[i]), b)));
+        std::uint64_t bits = vaddvq_u32(vandq_u32(hit, lanes)); // no movemask on NEON
+        out[i / 64] |= bits << (i % 64);
+    }
+#endif
+
+    overlapTail(left, top, right, bottom, bounds, i, out);
+}
+
+const char* collisionKernelName() {
+#if COLLISION_KERNEL_AVX2
+    return "avx2";
+#elif COLLISION_KERNEL_SSE2
+    return "sse2";
+#elif COLLISION_KERNEL_NEON
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
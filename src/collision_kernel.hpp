@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Narrowphase: the player's box against many entity boxes at once.
+//
+// Candidates from the broadphase are packed as edges (left, top, right, bottom),
+// four or eight at a time go through one SIMD compare, and the result comes back
+// as a bitmask (bit i set = candidate i overlaps). The instruction set is picked
+// at compile time: AVX2, SSE2, NEON, or a scalar loop.
+
+struct PackedBounds {
+    std::vector<float> left, top, right, bottom;
+    std::vector<std::uint32_t> entity; // index into the entity arrays
+
+    std::size_t size() const { return left.size(); }
+
+    void clear() {
+        left.clear();
+        top.clear();
+        right.clear();
+        bottom.clear();
+        entity.clear();
+    }
+
+    void push(std::uint32_t i, float x, float y, float w, float h) {
+        left.push_back(x);
+        top.push_back(y);
+        right.push_back(x + w);
+        bottom.push_back(y + h);
+        entity.push_back(i);
+    }
+};
+
+// Same test as sf::FloatRect::intersects, for every packed box. mask is resized
+// to (size + 63) / 64 words.
+void overlapMask(float left, float top, float width, float height,
+                 const PackedBounds& bounds, std::vector<std::uint64_t>& mask);
+
+// Reference version, always scalar
+void overlapMaskScalar(float left, float top, float width, float height,
+                       const PackedBounds& bounds, std::vector<std::uint64_t>& mask);
+
+// "avx2", "sse2", "neon" or "scalar"
+const char* collisionKernelName();
+
+inline bool maskBit(const std::vector<std::uint64_t>& mask, std::size_t i) {
+    return (mask[i / 64] >> (i % 64)) & 1u;
+}
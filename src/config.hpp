@@ -0,0 +1,19 @@
+#pragma once
+
+// Shared game constants, used by both the windowed game and the headless simulation.
+
+const int WINDOW_WIDTH = 900;
+const int WINDOW_HEIGHT = 600;
+const int GROUND_Y = 500;
+const float GRAVITY = 0.3f; // Reduced from 0.5f to 0.3f for lighter gravity
+
+const int PLATFORM_WIDTH = 180;
+const int PLATFORM_HEIGHT = 30;
+const int COIN_SIZE = 32;
+const int OBSTACLE_SIZE = 40; // Increased from 32 to 40 for slightly taller obstacles
+const int LIFE_ICON_SIZE = 32;
+const int MAX_LIVES = 3;
+
+// Player size: one frame of assets/player_spritesheet.png (the frames are in assets/animations.txt)
+const int FRAME_WIDTH = 1773 / 12;   // 75
+const int FRAME_HEIGHT = 150;      // 365
@@ -0,0 +1,16 @@
+#include "frame_arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+FrameArena::FrameArena(std::size_t capacity) : buffer(new unsigned char[capacity]), size(capacity) {}
+
+void* FrameArena::allocate(std::size_t bytes, std::size_t alignment) {
+    std::uintptr_t base = reinterpret_cast<std::uintptr_t>(buffer.get());
+    std::size_t start = ((base + offset + alignment - 1) & ~std::uintptr_t(alignment - 1)) - base;
+    if (start + bytes > size) throw std::runtime_error("Frame arena out of space");
+    offset = start + bytes;
+    peak = std::max(peak, offset);
+    return buffer.get() + start;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+// Linear allocator for per-frame temporaries.
+//
+// One buffer is allocated up front; allocate() bumps an offset into it and reset()
+// at the top of each frame drops everything at once. Nothing is freed individually
+// and no destructors run, so it is for plain data: formatted text, scratch arrays.
+class FrameArena {
+public:
+    explicit FrameArena(std::size_t capacity);
+
+    // Throws std::runtime_error if the frame has used up the arena (make it bigger)
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T* allocateArray(std::size_t count) {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    void reset() { offset = 0; }
+
+    std::size_t used() const { return offset; }
+    std::size_t highWater() const { return peak; } // most used in any frame so far
+    std::size_t capacity() const { return size; }
+
+private:
+    std::unique_ptr<unsigned char[]> buffer;
+    std::size_t size;
+    std::size_t offset = 0;
+    std::size_t peak = 0;
+};
@@ -0,0 +1,82 @@
+#include "frame_pacer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+// Sleep until this long before the deadline, then spin. Covers the usual oversleep.
+const std::chrono::microseconds SPIN_MARGIN(1500);
+
+} // namespace
+
+const char* pacingModeName(PacingMode mode) {
+    static const char* names[] = {"vsync", "spin", "uncapped", "fixed"};
+    return names[std::size_t(mode)];
+}
+
+bool parsePacingMode(const std::string& name, PacingMode& mode) {
+    for (std::size_t i = 0; i < PACING_MODE_COUNT; ++i) {
+        if (name == pacingModeName(PacingMode(i))) {
+            mode = PacingMode(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void IntervalStats::add(double milliseconds) {
+    count++;
+    double delta = milliseconds - mean;
+    mean += delta / double(count);
+    m2 += delta * (milliseconds - mean);
+    max = std::max(max, milliseconds);
+}
+
+double IntervalStats::stddev() const {
+    return count > 1 ? std::sqrt(m2 / double(count - 1)) : 0.0;
+}
+
+FramePacer::FramePacer(PacingMode mode, unsigned int rate)
+    : currentMode(mode),
+      targetRate(rate > 0 ? rate : DEFAULT_RATE),
+      period(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetRate))),
+      deadline(Clock::now()) {}
+
+void FramePacer::setMode(PacingMode mode) {
+    currentMode = mode;
+    deadline = Clock::now();
+    havePresent = false;
+}
+
+void FramePacer::wait() {
+    if (currentMode != PacingMode::SleepSpin) return;
+
+    deadline += period;
+    Clock::time_point now = Clock::now();
+    if (deadline < now) {
+        // Missed it (a hitch, or the window was being dragged): start over from now
+        // rather than rushing out frames to catch up
+        deadline = now;
+        return;
+    }
+    if (deadline - now > SPIN_MARGIN) std::this_thread::sleep_until(deadline - SPIN_MARGIN);
+    while (Clock::now() < deadline) {
+        // busy-wait the last stretch
+    }
+}
+
+void FramePacer::presented() {
+    Clock::time_point now = Clock::now();
+    if (havePresent) {
+        modeStats[std::size_t(currentMode)].add(std::chrono::duration<double, std::milli>(now - lastPresent).count());
+    }
+    lastPresent = now;
+    havePresent = true;
+}
+
+void FramePacer::idle() {
+    deadline = Clock::now();
+    havePresent = false;
+}
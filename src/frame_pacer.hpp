@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+// Frame pacing: how the main loop waits between presents.
+//
+// SFML's setFramerateLimit() only sleeps, and a sleep can overshoot by a millisecond
+// or more on Linux, which shows up as uneven frame intervals. SleepSpin sleeps until
+// shortly before the frame's deadline and busy-waits the rest, against absolute
+// deadlines so errors don't add up. The window side (vsync on or off, SFML's limiter)
+// is applied by the caller according to the mode.
+//
+// The interval between presents is recorded per mode, so the modes can be compared
+// on the monitor at hand.
+enum class PacingMode {
+    VSync,     // wait for the display's refresh
+    SleepSpin, // sleep, then busy-wait to the deadline, at a set rate
+    Uncapped,  // no waiting at all
+    Fixed,     // SFML's sleep-only limiter at a set rate (the old behaviour)
+};
+const std::size_t PACING_MODE_COUNT = 4;
+
+const char* pacingModeName(PacingMode mode);
+// Accepts the names above in lower case ("vsync", "spin", "uncapped", "fixed"); false if unknown
+bool parsePacingMode(const std::string& name, PacingMode& mode);
+
+// Mean, standard deviation and max of frame intervals, in milliseconds (Welford's method)
+struct IntervalStats {
+    std::size_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    double max = 0.0;
+
+    void add(double milliseconds);
+    double stddev() const;
+};
+
+class FramePacer {
+public:
+    static constexpr unsigned int DEFAULT_RATE = 60;
+
+    // rate is for the paced modes; 0 falls back to DEFAULT_RATE
+    FramePacer(PacingMode mode, unsigned int rate);
+
+    PacingMode mode() const { return currentMode; }
+    unsigned int rate() const { return targetRate; }
+    void setMode(PacingMode mode);
+
+    // Right before display(): in SleepSpin mode, waits for this frame's deadline
+    void wait();
+    // Right after display(): records the interval since the previous present
+    void presented();
+    // Instead of wait()/presented() for a frame shown after sleeping (idle menus): the next
+    // paced frame starts over rather than counting the sleep as one long interval
+    void idle();
+
+    const IntervalStats& stats(PacingMode mode) const { return modeStats[std::size_t(mode)]; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    PacingMode currentMode;
+    unsigned int targetRate;
+    Clock::duration period;
+    Clock::time_point deadline;
+    Clock::time_point lastPresent;
+    bool havePresent = false; // false after a mode switch or idle frame, so the next interval isn't counted
+    std::array<IntervalStats, PACING_MODE_COUNT> modeStats;
+};
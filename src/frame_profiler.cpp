@@ -0,0 +1,100 @@
+#include "frame_profiler.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// Stats over count samples; sorted is scratch space at least count long
+template <std::size_t N>
+FrameProfiler::Stats statsOf(std::array<float, N>& sorted, std::size_t count, float current) {
+    FrameProfiler::Stats result;
+    if (count == 0) return result;
+
+    float sum = 0.0f;
+    for (std::size_t i = 0; i < count; ++i) sum += sorted[i];
+    result.current = current;
+    result.average = sum / count;
+
+    // 99th percentile: the sample 1% of samples are slower than
+    std::size_t p99Index = std::min(count - 1, count * 99 / 100);
+    std::nth_element(sorted.begin(), sorted.begin() + p99Index, sorted.begin() + count);
+    result.p99 = sorted[p99Index];
+    result.max = *std::max_element(sorted.begin(), sorted.begin() + count);
+    return result;
+}
+
+} // namespace
+
+bool FrameProfiler::openCsv(const std::string& path) {
+    csv.open(path);
+    if (!csv) return false;
+    csv << "frame,events_ms,update_ms,draw_ms,display_ms,total_ms,input_latency_ms\n";
+    return true;
+}
+
+void FrameProfiler::beginFrame() {
+    endFrame();
+    frameStart = Clock::now();
+    frameOpen = true;
+    open.fill(0.0f);
+}
+
+void FrameProfiler::endFrame() {
+    if (!frameOpen) return;
+    open[FRAME_TOTAL] = std::chrono::duration<float, std::milli>(Clock::now() - frameStart).count();
+    finishFrame();
+    frameOpen = false;
+}
+
+void FrameProfiler::add(ProfilePhase phase, float milliseconds) {
+    open[std::size_t(phase)] += milliseconds;
+}
+
+void FrameProfiler::addInputLatency(float milliseconds) {
+    latencies[latencyNext] = milliseconds;
+    latencyNext = (latencyNext + 1) % LATENCY_HISTORY;
+    latencyCount = std::min(latencyCount + 1, LATENCY_HISTORY);
+    openLatency = milliseconds;
+}
+
+void FrameProfiler::finishFrame() {
+    for (std::size_t row = 0; row <= PROFILE_PHASE_COUNT; ++row) history[row][next] = open[row];
+    next = (next + 1) % HISTORY;
+    count = std::min(count + 1, HISTORY);
+
+    if (csv.is_open()) {
+        csv << frameNumber;
+        for (float ms : open) csv << ',' << ms;
+        csv << ',';
+        if (openLatency >= 0.0f) csv << openLatency; // blank on frames without a jump
+        csv << '\n';
+        // Flush now and then, so a crash or kill still leaves most of the capture
+        if (frameNumber % 300 == 0) csv.flush();
+    }
+    frameNumber++;
+    openLatency = -1.0f;
+}
+
+FrameProfiler::Stats FrameProfiler::stats(std::size_t row) const {
+    if (count == 0) return Stats();
+    std::array<float, HISTORY> sorted;
+    for (std::size_t i = 0; i < count; ++i) sorted[i] = frameTime(row, i);
+    return statsOf(sorted, count, frameTime(row, count - 1));
+}
+
+FrameProfiler::Stats FrameProfiler::inputLatency() const {
+    if (latencyCount == 0) return Stats();
+    std::array<float, LATENCY_HISTORY> sorted = latencies;
+    return statsOf(sorted, latencyCount, latencies[(latencyNext + LATENCY_HISTORY - 1) % LATENCY_HISTORY]);
+}
+
+float FrameProfiler::frameTime(std::size_t row, std::size_t i) const {
+    // Oldest first: the ring starts at `next` once it's full
+    std::size_t first = count < HISTORY ? 0 : next;
+    return history[row][(first + i) % HISTORY];
+}
+
+const char* FrameProfiler::phaseName(std::size_t row) {
+    static const char* names[] = {"events", "update", "draw", "display", "frame"};
+    return names[std::min(row, FRAME_TOTAL)];
+}
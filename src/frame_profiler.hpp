@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <string>
+
+// Per-frame phase timings for the main loop.
+//
+// Wrap each phase in a ProfileScope; beginFrame() closes the previous frame and
+// starts the next. The last HISTORY frames are kept for the overlay, and every
+// frame can also be appended to a CSV file for capturing hitches on site.
+//
+// endFrame() closes a frame early, so time spent between frames (waiting for an
+// event on an idle screen) isn't counted as part of it.
+//
+// Input-to-present latency is kept alongside: the time from a jump key going down
+// to the display() call that first showed the jump, one sample per jump.
+
+enum class ProfilePhase { Events, Update, Draw, Display };
+const std::size_t PROFILE_PHASE_COUNT = 4;
+
+class FrameProfiler {
+public:
+    static constexpr std::size_t HISTORY = 240; // 4 s at 60 fps
+    static constexpr std::size_t LATENCY_HISTORY = 64; // jumps
+
+    // Row PROFILE_PHASE_COUNT of the stats/history is the whole frame
+    static constexpr std::size_t FRAME_TOTAL = PROFILE_PHASE_COUNT;
+
+    struct Stats {
+        float current = 0.0f; // milliseconds, last finished frame
+        float average = 0.0f;
+        float p99 = 0.0f;
+        float max = 0.0f;
+    };
+
+    // Writes one row per frame from now on; returns false if the file can't be opened
+    bool openCsv(const std::string& path);
+
+    void beginFrame();
+    void endFrame();
+    void add(ProfilePhase phase, float milliseconds);
+    void addInputLatency(float milliseconds);
+
+    // Over the frames in the history. row is a ProfilePhase or FRAME_TOTAL.
+    Stats stats(std::size_t row) const;
+    // Over the last LATENCY_HISTORY latency samples
+    Stats inputLatency() const;
+
+    // Finished frames in the history, and the i-th oldest one's time for a row
+    std::size_t frameCount() const { return count; }
+    float frameTime(std::size_t row, std::size_t i) const;
+
+    static const char* phaseName(std::size_t row);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void finishFrame();
+
+    std::array<float, PROFILE_PHASE_COUNT + 1> open{}; // frame being measured
+    std::array<std::array<float, HISTORY>, PROFILE_PHASE_COUNT + 1> history{};
+    std::size_t next = 0;  // history slot the next finished frame goes to
+    std::size_t count = 0;
+    long frameNumber = 0;
+    bool frameOpen = false;
+    Clock::time_point frameStart;
+
+    std::array<float, LATENCY_HISTORY> latencies{};
+    std::size_t latencyNext = 0;
+    std::size_t latencyCount = 0;
+    float openLatency = -1.0f; // sample taken during the frame being measured, for the CSV
+
+    std::ofstream csv;
+};
+
+// Adds the time from construction to destruction to one phase of the current frame
+class ProfileScope {
+public:
+    ProfileScope(FrameProfiler& profiler_, ProfilePhase phase_)
+        : profiler(profiler_), phase(phase_), start(std::chrono::steady_clock::now()) {}
+
+    ~ProfileScope() {
+        std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        profiler.add(phase, elapsed.count());
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    FrameProfiler& profiler;
+    ProfilePhase phase;
+    std::chrono::steady_clock::time_point start;
+};
@@ -0,0 +1,177 @@
+#include "game_scene.hpp"
+
+#include <stdexcept>
+#include <string>
+
+GameScene::GameScene(const LoadedAssets& assets) {
+    // --- Gameplay sprites, packed into one atlas ---
+    // Obstacles are resampled to their drawn size here, so they never need scaling at draw time.
+    atlas.addImage("player", assets.player);
+    atlas.addImage("platform", assets.platform);
+    atlas.addImage("coin", assets.coin);
+    atlas.addImage("obstacle1", assets.obstacle1, unsigned(obstacleSize(1)), unsigned(obstacleSize(1)));
+    atlas.addImage("obstacle2", assets.obstacle2, unsigned(obstacleSize(2)), unsigned(obstacleSize(2)));
+    atlas.addImage("life", assets.life);
+    atlas.pack();
+    platformRect = atlas.getRect("platform");
+    coinRect = atlas.getRect("coin");
+    lifeRect = atlas.getRect("life");
+
+    animations.parse(assets.animations);
+    animations.resolve(atlas);
+    coinAnimation = animated.add(animations.find("coin_spin"));
+    obstacleAnimations[0] = animated.add(animations.find("obstacle1_idle"));
+    obstacleAnimations[1] = animated.add(animations.find("obstacle2_idle"));
+    playerJumpClip = animations.find("player_jump");
+    playerLandClip = animations.find("player_land"); // carries on into the run
+    playerAnimation = animated.add(playerLandClip);
+
+    if (!backgroundTexture.loadFromImage(assets.background)) {
+        throw std::runtime_error("Failed to load background image!");
+    }
+    if (!groundTexture.loadFromImage(assets.ground)) {
+        throw std::runtime_error("Failed to load ground texture!");
+    }
+    // Clouds where the old recycled cloud sprites started, on a strip one old recycle loop wide
+    const sf::Vector2u cloudPositions[] = {{200, 80}, {450, 120}, {700, 80}};
+    if (!cloudTexture.loadFromImage(makeCloudStrip(assets.cloud, WINDOW_WIDTH + 200, 120 + assets.cloud.getSize().y,
+                                                   cloudPositions, 3))) {
+        throw std::runtime_error("Failed to load cloud texture!");
+    }
+    backgroundTexture.setRepeated(true);
+    cloudTexture.setRepeated(true);
+    groundTexture.setRepeated(true);
+
+    const std::size_t skyLayer = batch.addLayer(backgroundTexture);
+    const std::size_t cloudLayer = batch.addLayer(cloudTexture);
+    worldLayer = batch.addLayer(atlas.getTexture());
+    const std::size_t groundLayer = batch.addLayer(groundTexture);
+    overlayLayer = batch.addLayer(atlas.getTexture());
+
+    // Parallax: the sky and hills picture drifts, clouds move at half speed, the ground with the platforms
+    backdropLayers[0] = {skyLayer, backgroundTexture.getSize(), 0.0f, float(WINDOW_HEIGHT), 0.1f};
+    backdropLayers[1] = {cloudLayer, cloudTexture.getSize(), 0.0f, float(cloudTexture.getSize().y), 0.5f};
+    groundParallax = {groundLayer, groundTexture.getSize(), float(GROUND_Y), 100.0f, 1.0f};
+
+    // --- HUD text ---
+    const sf::Font& font = assets.font;
+    sf::Text& scoreText = scoreHud.text;
+    sf::Text& coinText = coinHud.text;
+    scoreText.setFont(font);
+    scoreText.setCharacterSize(24);
+    scoreText.setFillColor(sf::Color::White);
+    scoreText.setPosition(10, 50);
+    coinText.setFont(font);
+    coinText.setCharacterSize(24);
+    coinText.setFillColor(sf::Color::Yellow);
+    coinText.setPosition(10, 80);
+    gameOverText.setFont(font);
+    gameOverText.setCharacterSize(48);
+    gameOverText.setFillColor(sf::Color::Red);
+    gameOverText.setString("GAME OVER");
+    gameOverText.setPosition(WINDOW_WIDTH / 2 - 120, WINDOW_HEIGHT / 2 - 60);
+    restartText.setFont(font);
+    restartText.setCharacterSize(24);
+    restartText.setFillColor(sf::Color::White);
+    restartText.setString("Press R to Restart");
+    restartText.setPosition(WINDOW_WIDTH / 2 - 80, WINDOW_HEIGHT / 2 - 10);
+    practiceText.setFont(font);
+    practiceText.setCharacterSize(18);
+    practiceText.setFillColor(sf::Color::White);
+    practiceText.setString("Practice: Backspace rewinds, Enter restarts the level");
+    practiceText.setPosition(10, 115);
+
+    // Rasterize the glyphs the changing numbers need now, so no frame stalls on a new character
+    const std::string numberGlyphs = "0123456789.: ";
+    prewarmGlyphs(scoreText, "Time" + numberGlyphs);
+    prewarmGlyphs(coinText, "Coins" + numberGlyphs);
+    prewarmGlyphs(gameOverText);
+    prewarmGlyphs(restartText);
+    prewarmGlyphs(practiceText);
+}
+
+void GameScene::applySizes(SimConfig& config) const {
+    config.platformWidth = float(platformRect.width);
+    config.platformHeight = float(platformRect.height);
+    config.coinWidth = float(coinRect.width);
+    config.coinHeight = float(coinRect.height);
+}
+
+void GameScene::addFrame(std::size_t layer, const AnimationFrame& frame, float x, float y, float width,
+                         float height) {
+    const float drawnWidth = width * frame.scaleX;
+    batch.add(layer, frame.textureRect, x + (width - drawnWidth) * 0.5f, y, drawnWidth, height);
+}
+
+void GameScene::draw(sf::RenderTarget& target, const RenderSnapshot& snapshot, float alpha) {
+    target.clear(sf::Color(100, 149, 237)); // sky blue
+
+    batch.clear();
+
+    // Animation frames for everything at once: in the air the player holds the jump clip,
+    // on the ground it lands and then runs
+    animated.clip[playerAnimation] = snapshot.playerAirborne ? playerJumpClip : playerLandClip;
+    animated.start[playerAnimation] = snapshot.playerAirborneChangedAt;
+    animated.update(animations, interpolate(snapshot.previousElapsed, snapshot.elapsed, alpha));
+
+    // --- Background first: sky and clouds, one scrolling quad each ---
+    const double scrolled = snapshot.previousScrolled + (snapshot.scrolled - snapshot.previousScrolled) * alpha;
+    for (const ParallaxLayer& layer : backdropLayers) {
+        batch.add(layer.batchLayer, layer.textureRect(scrolled), 0, layer.y, WINDOW_WIDTH, layer.height);
+    }
+
+    // Platforms
+    for (const SpriteState& platform : snapshot.platforms) {
+        float x = interpolateX(platform.previousX, platform.x, alpha);
+        batch.add(worldLayer, platformRect, x, platform.y, platform.w, platform.h);
+    }
+
+    // Coins (collected ones aren't in the snapshot)
+    const AnimationFrame& coinFrame = *animated.frame[coinAnimation];
+    for (const SpriteState& coin : snapshot.coins) {
+        float x = interpolateX(coin.previousX, coin.x, alpha);
+        addFrame(worldLayer, coinFrame, x, coin.y, coin.w, coin.h);
+    }
+
+    // Obstacles (already packed at their drawn size)
+    const AnimationFrame* obstacleFrames[2] = {animated.frame[obstacleAnimations[0]],
+                                               animated.frame[obstacleAnimations[1]]};
+    for (const SpriteState& obstacle : snapshot.obstacles) {
+        float x = interpolateX(obstacle.previousX, obstacle.x, alpha);
+        addFrame(worldLayer, *obstacleFrames[obstacle.type == 2 ? 1 : 0], x, obstacle.y, obstacle.w, obstacle.h);
+    }
+
+    // Ground, 100 pixels high, scrolling with the platforms
+    batch.add(groundParallax.batchLayer, groundParallax.textureRect(scrolled), 0, groundParallax.y, WINDOW_WIDTH,
+              groundParallax.height);
+
+    // Player
+    addFrame(overlayLayer, *animated.frame[playerAnimation], snapshot.playerX,
+             interpolate(snapshot.playerPreviousY, snapshot.playerY, alpha), FRAME_WIDTH, FRAME_HEIGHT);
+
+    // Lives
+    for (int i = 0; i < snapshot.lives; ++i) {
+        batch.add(overlayLayer, lifeRect, 10.0f + i * (LIFE_ICON_SIZE + 5), 10, float(lifeRect.width),
+                  float(lifeRect.height));
+    }
+
+    batch.draw(target);
+    lastDrawCalls = batch.drawCalls();
+
+    // Score and coin count (gameEndTime stops at the final time when game over)
+    scoreHud.set(static_cast<int>(snapshot.gameEndTime));
+    target.draw(scoreHud.text);
+    coinHud.set(snapshot.coinCount);
+    target.draw(coinHud.text);
+    lastDrawCalls += 2;
+
+    if (snapshot.practice) {
+        target.draw(practiceText);
+        lastDrawCalls++;
+    }
+    if (snapshot.gameOver) {
+        target.draw(gameOverText);
+        target.draw(restartText);
+        lastDrawCalls += 2;
+    }
+}
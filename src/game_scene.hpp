@@ -0,0 +1,66 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+
+#include "animation.hpp"
+#include "asset_loader.hpp"
+#include "hud.hpp"
+#include "parallax.hpp"
+#include "sim_thread.hpp"
+#include "sprite_batch.hpp"
+#include "texture_atlas.hpp"
+
+// The in-game picture: parallax backdrop, level, player, lives and HUD text, drawn from
+// a RenderSnapshot. The window and the offscreen render benchmark (render_bench.hpp) both
+// draw through here, so the benchmark's timings and golden images are of what players see.
+class GameScene {
+public:
+    // Packs the sprites and uploads the textures, so it needs a GL context (any
+    // window or render texture). assets must outlive the scene (the font is used from there).
+    explicit GameScene(const LoadedAssets& assets);
+
+    GameScene(const GameScene&) = delete;
+    GameScene& operator=(const GameScene&) = delete;
+
+    // Fills in the collision box sizes of the packed sprites
+    void applySizes(SimConfig& config) const;
+
+    // The sky picture, also used behind the menus
+    const sf::Texture& background() const { return backgroundTexture; }
+
+    // Clears target and draws the scene alpha of the way between the snapshot's last two ticks
+    void draw(sf::RenderTarget& target, const RenderSnapshot& snapshot, float alpha);
+
+    // Number of target.draw calls the last draw() made
+    int drawCalls() const { return lastDrawCalls; }
+
+private:
+    // Queues an animation frame over the width x height box at (x, y)
+    void addFrame(std::size_t layer, const AnimationFrame& frame, float x, float y, float width, float height);
+
+    TextureAtlas atlas;
+    sf::IntRect platformRect, coinRect, lifeRect;
+    sf::Texture backgroundTexture, groundTexture, cloudTexture;
+
+    // One draw call per layer, back to front. The ground sits between the world and the player.
+    SpriteBatch batch;
+    std::size_t worldLayer = 0;   // platforms, coins, obstacles
+    std::size_t overlayLayer = 0; // player, life icons
+    ParallaxLayer backdropLayers[2];
+    ParallaxLayer groundParallax;
+
+    // Sprite animations (assets/animations.txt). Coins all spin in step, and each obstacle
+    // type idles in step, so each group is one entry in the set however many are on screen.
+    AnimationLibrary animations;
+    AnimationSet animated;
+    std::size_t coinAnimation = 0, playerAnimation = 0;
+    std::size_t obstacleAnimations[2] = {};
+    std::size_t playerJumpClip = 0, playerLandClip = 0;
+
+    // HUD values only re-lay out their text when the number changes
+    HudValueText scoreHud{"Time: "}, coinHud{"Coins: "};
+    sf::Text gameOverText, restartText, practiceText;
+
+    int lastDrawCalls = 0;
+};
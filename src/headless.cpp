@@ -0,0 +1,72 @@
+#include "headless.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+SimInput botInput(const World& world) {
+    SimInput input;
+    const EntityArrays& obstacles = world.obstacles;
+    for (std::size_t i = 0; i < obstacles.size(); ++i) {
+        float distance = obstacles.x[i] - (world.player.x + FRAME_WIDTH);
+        if (!obstacles.hidden(i) && distance > 0 && distance < 60 + 20 * world.gameSpeed) {
+            input.jump = true;
+        }
+    }
+    return input;
+}
+
+int runHeadless(float simSeconds, unsigned int seed, const SimConfig& config) {
+    World world;
+    world.config = config;
+    resetWorld(world, seed);
+
+    long totalTicks = long(simSeconds / world.config.tickSeconds);
+    int runs = 0;
+    long coins = 0;
+    float longestRun = 0.0f;
+
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < totalTicks; ++i) {
+        step(world, botInput(world));
+        if (world.gameOver) {
+            runs++;
+            coins += world.coinCount;
+            longestRun = std::max(longestRun, world.gameEndTime);
+            resetWorld(world, seed + runs);
+        }
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Simulated " << simSeconds << " s (" << totalTicks << " ticks) in "
+              << wallSeconds << " s wall clock\n";
+    std::cout << "Speed: " << (wallSeconds > 0 ? simSeconds / wallSeconds : 0) << "x real time\n";
+    std::cout << "Finished runs: " << runs << ", coins: " << coins
+              << ", longest run: " << longestRun << " s\n";
+    return 0;
+}
+
+int runReplay(const Replay& replay) {
+    World world;
+    startReplay(world, replay);
+
+    auto start = std::chrono::steady_clock::now();
+    while (!world.gameOver && std::uint64_t(world.tick) < replay.result.tickCount) {
+        step(world, replay.input(std::size_t(world.tick)));
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    ReplayResult result = resultOf(world);
+    std::cout << "Replayed " << result.tickCount << " ticks (" << result.tickCount * replay.config.tickSeconds
+              << " s) in " << wallSeconds << " s wall clock\n";
+    std::cout << "Run ended at " << result.gameEndTime << " s with " << result.coinCount << " coins, "
+              << result.lives << " lives\n";
+    if (!(result == replay.result)) {
+        std::cout << "DIVERGED: recorded " << replay.result.tickCount << " ticks, "
+                  << replay.result.coinCount << " coins, " << replay.result.lives << " lives, ended at "
+                  << replay.result.gameEndTime << " s\n";
+        return 1;
+    }
+    std::cout << "Matches the recording\n";
+    return 0;
+}
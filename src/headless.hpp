@@ -0,0 +1,16 @@
+#pragma once
+
+#include "replay.hpp"
+#include "simulation.hpp"
+
+// Scripted stand-in for a player: jumps when an obstacle gets close. Used by the
+// headless and batch runs.
+SimInput botInput(const World& world);
+
+// Runs the simulation without a window, audio or textures.
+// Plays back-to-back runs for the given number of simulated seconds and prints a summary.
+int runHeadless(float simSeconds, unsigned int seed, const SimConfig& config);
+
+// Plays a replay back as fast as possible and checks it ends the way it was recorded.
+// Returns 0 if it does, 1 if the run diverged.
+int runReplay(const Replay& replay);
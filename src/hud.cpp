@@ -0,0 +1,15 @@
+#include "hud.hpp"
+
+void assignAscii(sf::String& to, const char* text, std::size_t length) {
+    to.clear();
+    for (std::size_t i = 0; i < length; ++i) to += sf::String(sf::Uint32(static_cast<unsigned char>(text[i])));
+}
+
+void prewarmGlyphs(const sf::Text& text, const std::string& extra) {
+    const sf::Font* font = text.getFont();
+    if (!font) return;
+    const unsigned size = text.getCharacterSize();
+    const bool bold = (text.getStyle() & sf::Text::Bold) != 0;
+    for (sf::Uint32 c : text.getString()) font->getGlyph(c, size, bold);
+    for (unsigned char c : extra) font->getGlyph(c, size, bold);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <string>
+
+#include "hud_text.hpp"
+
+// Copies ASCII text into an sf::String, reusing its storage. Converting a std::string
+// or const char* to sf::String allocates a new one every time; this doesn't once
+// `to` has held text this long.
+void assignAscii(sf::String& to, const char* text, std::size_t length);
+
+// An on-screen HUD value. sf::Text only re-lays out its glyphs after setString,
+// so calling it only when the value changes keeps the geometry between frames.
+// The text goes through a kept sf::String, so a change doesn't allocate either.
+class HudValueText {
+public:
+    explicit HudValueText(const char* prefix) : counter(prefix) {}
+
+    void set(int value) {
+        if (!counter.set(value)) return;
+        assignAscii(string, counter.text().data(), counter.text().size());
+        text.setString(string);
+    }
+
+    sf::Text text;
+
+private:
+    HudCounter counter;
+    sf::String string;
+};
+
+// Rasterizes the glyphs text will need (its own string plus extra characters) into
+// the font's glyph cache now, instead of on the first frame they are drawn
+void prewarmGlyphs(const sf::Text& text, const std::string& extra = "");
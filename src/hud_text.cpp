@@ -0,0 +1,19 @@
+#include "hud_text.hpp"
+
+#include <charconv>
+
+HudCounter::HudCounter(const char* prefix_) : prefix(prefix_) {
+    cachedText.reserve(prefix.size() + 12);
+}
+
+bool HudCounter::set(int newValue) {
+    if (valid && newValue == value) return false;
+    value = newValue;
+    valid = true;
+
+    char digits[12];
+    char* end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+    cachedText.assign(prefix);
+    cachedText.append(digits, end);
+    return true;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+// Text for an integer HUD value ("Time: 12"). The string is only rebuilt when the
+// value changes, which for the HUD is about once a second, not every frame.
+// Kept free of SFML so it can be benchmarked on its own.
+class HudCounter {
+public:
+    explicit HudCounter(const char* prefix);
+
+    // Returns true if the value, and so the text, changed since the last call
+    bool set(int value);
+
+    const std::string& text() const { return cachedText; }
+
+private:
+    std::string prefix;
+    std::string cachedText;
+    int value = 0;
+    bool valid = false;
+};
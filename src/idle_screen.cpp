@@ -0,0 +1,35 @@
+#include "idle_screen.hpp"
+
+#include <stdexcept>
+#include <thread>
+
+IdleScreen::IdleScreen(unsigned int width, unsigned int height) {
+    if (!canvas.create(width, height)) throw std::runtime_error("Failed to create the idle screen texture");
+    sprite.setTexture(canvas.getTexture(), true);
+}
+
+sf::RenderTarget* IdleScreen::compose(std::uint64_t key_, const sf::Color& background) {
+    if (cached && key == key_) return nullptr;
+    key = key_;
+    cached = true;
+    needsDisplay = true;
+    canvas.clear(background);
+    return &canvas;
+}
+
+void IdleScreen::draw(sf::RenderTarget& target) {
+    if (needsDisplay) {
+        canvas.display();
+        needsDisplay = false;
+    }
+    target.draw(sprite);
+}
+
+bool IdleScreen::waitEvent(sf::Window& window, sf::Event& event) {
+    const auto until = std::chrono::steady_clock::now() + REFRESH_INTERVAL;
+    while (!window.pollEvent(event)) {
+        if (!window.isOpen() || std::chrono::steady_clock::now() >= until) return false;
+        std::this_thread::sleep_for(POLL_INTERVAL);
+    }
+    return true;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <chrono>
+#include <cstdint>
+
+// Idle rendering for screens that only change on input (main menu, pause, high scores).
+//
+// The screen is drawn once into a texture and shown from there, and instead of redrawing
+// at the frame rate the loop sleeps in waitEvent() until input arrives or the refresh
+// timer runs out. SFML 2 has no waitEvent with a timeout, so it polls in POLL_INTERVAL
+// sleeps, which is well under a millisecond of CPU per second while a menu is up.
+class IdleScreen {
+public:
+    // Longest sleep between redraws without input (also how often timed screen changes get a frame)
+    static constexpr std::chrono::milliseconds REFRESH_INTERVAL{500};
+    // Input is noticed within this
+    static constexpr std::chrono::milliseconds POLL_INTERVAL{10};
+
+    // Throws std::runtime_error if the render texture can't be created
+    IdleScreen(unsigned int width, unsigned int height);
+
+    // Returns the (cleared) canvas to draw the screen into if key differs from the cached
+    // screen's, or null if the cached one is still right. key identifies what is on screen.
+    sf::RenderTarget* compose(std::uint64_t key, const sf::Color& background);
+    // Draws the cached screen to target
+    void draw(sf::RenderTarget& target);
+
+    // Waits for the next event, up to REFRESH_INTERVAL. Returns false on timeout.
+    static bool waitEvent(sf::Window& window, sf::Event& event);
+
+private:
+    sf::RenderTexture canvas;
+    sf::Sprite sprite;
+    std::uint64_t key = 0;
+    bool cached = false;
+    bool needsDisplay = false; // composed since the last draw, canvas.display() still due
+};
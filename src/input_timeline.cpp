@@ -0,0 +1,34 @@
+#include "input_timeline.hpp"
+
+void InputTimeline::apply(const InputEvent& event) {
+    if (event.action == InputAction::JumpPressed) {
+        held = true;
+        pressedThisTick = true;
+        pending = true;
+        pressTime = event.time;
+    } else {
+        held = false;
+    }
+}
+
+SimInput InputTimeline::advance(std::chrono::steady_clock::time_point tickTime) {
+    while (InputEvent* event = events.front()) {
+        if (event->time > tickTime) break; // belongs to a later tick
+        apply(*event);
+        events.pop();
+    }
+    SimInput input;
+    input.jump = held;
+    input.jumpPressed = pressedThisTick;
+    pressedThisTick = false;
+    return input;
+}
+
+void InputTimeline::drain() {
+    while (InputEvent* event = events.front()) {
+        apply(*event);
+        events.pop();
+    }
+    pressedThisTick = false;
+    pending = false;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "simulation.hpp"
+#include "spsc_queue.hpp"
+
+// Timestamped input, applied at the tick it happened in.
+//
+// The main thread stamps key events as it polls them and pushes them here; the
+// simulation thread asks for the input of each tick as it runs it. Events are applied
+// in order up to the wall time the tick was due, so a press that came between two
+// frames lands on the right tick instead of waiting for the next frame's poll, and a
+// tap shorter than a tick still counts as a press.
+enum class InputAction : std::uint8_t {
+    JumpPressed,
+    JumpReleased,
+};
+
+struct InputEvent {
+    InputAction action;
+    std::chrono::steady_clock::time_point time;
+};
+
+class InputTimeline {
+public:
+    // Main thread. False if the queue is full (the event is dropped).
+    bool push(const InputEvent& event) { return events.push(event); }
+
+    // Simulation thread: applies the events up to tickTime and returns that tick's input
+    SimInput advance(std::chrono::steady_clock::time_point tickTime);
+
+    // Simulation thread, while no ticks run: applies everything queued so the held
+    // state stays right, but a press made while paused doesn't carry into the run
+    void drain();
+
+    // Wall time of the last press that hasn't started a jump yet; cleared by takePress()
+    bool pressPending() const { return pending; }
+    std::chrono::steady_clock::time_point takePress() {
+        pending = false;
+        return pressTime;
+    }
+
+private:
+    void apply(const InputEvent& event);
+
+    SpscQueue<InputEvent, 64> events;
+    bool held = false;
+    bool pressedThisTick = false;
+    bool pending = false;
+    std::chrono::steady_clock::time_point pressTime;
+};
@@ -0,0 +1,264 @@
+#include "leaderboard.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring> //For memcpy
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+const char LOG_MAGIC[4] = {'J', 'D', 'L', 'B'};
+const std::uint32_t LOG_VERSION = 1;
+const std::size_t HEADER_SIZE = 8;
+const std::size_t PAYLOAD_SIZE = 20; // time, coins, seed, date
+const std::size_t RECORD_SIZE = 4 + PAYLOAD_SIZE;
+
+std::uint32_t crc32(const unsigned char* data, std::size_t size) {
+    std::uint32_t crc = 0xFFFFFFFFu;
+    for (std::size_t i = 0; i < size; ++i) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+void encode(const RunRecord& run, unsigned char* out) {
+    unsigned char* payload = out + 4;
+    std::memcpy(payload, &run.time, 4);
+    std::memcpy(payload + 4, &run.coins, 4);
+    std::memcpy(payload + 8, &run.seed, 4);
+    std::memcpy(payload + 12, &run.date, 8);
+    std::uint32_t crc = crc32(payload, PAYLOAD_SIZE);
+    std::memcpy(out, &crc, 4);
+}
+
+bool decode(const unsigned char* in, RunRecord& run) {
+    std::uint32_t crc;
+    std::memcpy(&crc, in, 4);
+    const unsigned char* payload = in + 4;
+    if (crc != crc32(payload, PAYLOAD_SIZE)) return false;
+    std::memcpy(&run.time, payload, 4);
+    std::memcpy(&run.coins, payload + 4, 4);
+    std::memcpy(&run.seed, payload + 8, 4);
+    std::memcpy(&run.date, payload + 12, 8);
+    return true;
+}
+
+bool writeAll(int fd, const void* data, std::size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = ::write(fd, bytes, size);
+        if (written <= 0) return false;
+        bytes += written;
+        size -= std::size_t(written);
+    }
+    return true;
+}
+
+// After a rename, the directory entry has to reach the disk too
+void syncDirectoryOf(const std::string& path) {
+    std::string::size_type slash = path.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : path.substr(0, slash);
+    int dirFd = ::open(directory.c_str(), O_RDONLY);
+    if (dirFd < 0) return;
+    ::fsync(dirFd);
+    ::close(dirFd);
+}
+
+} // namespace
+
+bool Leaderboard::Better::operator()(const RunRecord& a, const RunRecord& b) const {
+    if (a.time != b.time) return a.time > b.time;
+    if (a.coins != b.coins) return a.coins > b.coins;
+    return a.date < b.date; // equal runs: the first one to get there ranks higher
+}
+
+Leaderboard::Leaderboard(std::string logPath_) : logPath(std::move(logPath_)) {}
+
+Leaderboard::~Leaderboard() {
+    stopWriter(); // writes whatever is still queued
+    if (fd >= 0) ::close(fd);
+}
+
+void Leaderboard::stopWriter() {
+    if (!writer.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_one();
+    writer.join();
+    stopping = false;
+}
+
+void Leaderboard::writeQueued() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    for (;;) {
+        queueReady.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty()) return; // stopping, and everything is written
+        RunRecord run = queue.front();
+        queue.pop_front();
+        lock.unlock();
+
+        unsigned char record[RECORD_SIZE];
+        encode(run, record);
+        if (!writeAll(fd, record, RECORD_SIZE) || ::fsync(fd) != 0) {
+            std::cerr << "Failed to write leaderboard " << logPath << std::endl;
+        }
+        lock.lock();
+    }
+}
+
+void Leaderboard::remember(const RunRecord& run) {
+    best.insert(run);
+    if (best.size() > TOP_K) best.erase(std::prev(best.end()));
+}
+
+void Leaderboard::load() {
+    stopWriter();
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+    best.clear();
+    runs = 0;
+
+    std::ifstream file(logPath, std::ios::binary);
+    if (!file) {
+        // First start: bring over the scores from the old text files
+        std::vector<RunRecord> imported = importLegacyScores();
+        for (const RunRecord& run : imported) remember(run);
+        runs = imported.size();
+        compact(imported);
+        writer = std::thread(&Leaderboard::writeQueued, this);
+        return;
+    }
+
+    // Only damage after a valid header is repaired. Anything else may be a log from a
+    // newer version (or not a log at all), so it is left as it is.
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < HEADER_SIZE || std::memcmp(data.data(), LOG_MAGIC, 4) != 0) {
+        throw std::runtime_error("Leaderboard " + logPath + " is not a leaderboard log, leaving it alone");
+    }
+    std::uint32_t version = 0;
+    std::memcpy(&version, data.data() + 4, 4);
+    if (version != LOG_VERSION) {
+        throw std::runtime_error("Leaderboard " + logPath + " has unknown version " + std::to_string(version) +
+                                 ", leaving it alone");
+    }
+
+    std::vector<RunRecord> all;
+    const unsigned char* cursor = reinterpret_cast<const unsigned char*>(data.data()) + HEADER_SIZE;
+    std::size_t remaining = data.size() - HEADER_SIZE;
+    all.reserve(remaining / RECORD_SIZE);
+    RunRecord run;
+    std::size_t corrupt = 0;
+    for (; remaining >= RECORD_SIZE; cursor += RECORD_SIZE, remaining -= RECORD_SIZE) {
+        // Records are fixed-size, so the ones after a corrupt record still line up
+        if (decode(cursor, run)) {
+            all.push_back(run);
+        } else {
+            corrupt++;
+        }
+    }
+    if (corrupt > 0) {
+        std::cerr << "Leaderboard " << logPath << ": skipped " << corrupt << " corrupt record(s)" << std::endl;
+    }
+    const bool damaged = remaining != 0 || corrupt > 0;
+
+    for (const RunRecord& run : all) remember(run);
+    runs = all.size();
+
+    // Rewrite only if something needs dropping; otherwise keep appending to the log as is
+    if (all.size() > MAX_RUNS) {
+        // The newest MAX_RUNS, plus any older run that is still in the top list
+        std::vector<std::size_t> order(all.size());
+        std::iota(order.begin(), order.end(), std::size_t(0));
+        const std::size_t topCount = std::min(TOP_K, all.size());
+        std::partial_sort(order.begin(), order.begin() + topCount, order.end(),
+                          [&](std::size_t a, std::size_t b) { return Better()(all[a], all[b]); });
+        std::vector<bool> inTop(all.size(), false);
+        for (std::size_t i = 0; i < topCount; ++i) inTop[order[i]] = true;
+
+        const std::size_t tailStart = all.size() - MAX_RUNS;
+        std::vector<RunRecord> keep;
+        keep.reserve(MAX_RUNS + topCount);
+        for (std::size_t i = 0; i < all.size(); ++i) {
+            if (i >= tailStart || inTop[i]) keep.push_back(all[i]);
+        }
+        compact(keep);
+    } else if (damaged) {
+        compact(all);
+    } else {
+        openForAppend();
+    }
+    writer = std::thread(&Leaderboard::writeQueued, this);
+}
+
+void Leaderboard::add(const RunRecord& run) {
+    if (fd >= 0) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            queue.push_back(run);
+        }
+        queueReady.notify_one();
+    }
+    remember(run);
+    runs++;
+}
+
+std::vector<RunRecord> Leaderboard::top(std::size_t count) const {
+    std::vector<RunRecord> result;
+    for (auto it = best.begin(); it != best.end() && result.size() < count; ++it) result.push_back(*it);
+    return result;
+}
+
+void Leaderboard::compact(const std::vector<RunRecord>& keep) {
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+
+    std::string data(LOG_MAGIC, 4);
+    data.append(reinterpret_cast<const char*>(&LOG_VERSION), 4);
+    unsigned char record[RECORD_SIZE];
+    for (const RunRecord& run : keep) {
+        encode(run, record);
+        data.append(reinterpret_cast<const char*>(record), RECORD_SIZE);
+    }
+
+    const std::string tempPath = logPath + ".tmp";
+    int tempFd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (tempFd < 0) throw std::runtime_error("Failed to create " + tempPath);
+    bool ok = writeAll(tempFd, data.data(), data.size()) && ::fsync(tempFd) == 0;
+    ::close(tempFd);
+    if (!ok || std::rename(tempPath.c_str(), logPath.c_str()) != 0) {
+        ::unlink(tempPath.c_str());
+        throw std::runtime_error("Failed to write leaderboard " + logPath);
+    }
+    syncDirectoryOf(logPath);
+    openForAppend();
+}
+
+void Leaderboard::openForAppend() {
+    fd = ::open(logPath.c_str(), O_WRONLY | O_APPEND);
+    if (fd < 0) throw std::runtime_error("Failed to open leaderboard " + logPath);
+}
+
+std::vector<RunRecord> Leaderboard::importLegacyScores() const {
+    std::vector<RunRecord> imported;
+    for (const char* path : {"assets/highscores.txt", "assets/highscore.txt"}) {
+        std::ifstream fin(path);
+        int score;
+        while (fin >> score) {
+            if (score <= 0) continue;
+            RunRecord run;
+            run.time = float(score);
+            imported.push_back(run);
+        }
+    }
+    return imported;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One finished run
+struct RunRecord {
+    float time = 0.0f;    // seconds survived, the score
+    std::int32_t coins = 0;
+    std::uint32_t seed = 0;
+    std::int64_t date = 0; // unix seconds
+};
+
+// Persistent leaderboard.
+//
+// Every finished run is appended to a log file as a fixed-size record with a
+// checksum and fsync'd, so a game over costs one small write, never a rewrite.
+// The append and fsync happen on a writer thread, so add() never waits for the disk.
+// A power cut can at worst leave a torn last record, which load() drops. A corrupt
+// record elsewhere is skipped too, and the records after it are still read.
+// The log is rewritten only to compact it (after a torn tail, or when it grows
+// past MAX_RUNS): into a temporary file that is fsync'd and then renamed over the
+// log, so the old or the new log is always complete on disk. Compaction keeps the
+// best TOP_K runs along with the newest ones, so it never changes the leaderboard.
+// A log with an unknown header or version is never rewritten.
+//
+// The best TOP_K runs are kept in memory in an ordered set: O(log K) per insert.
+//
+// Log layout (little-endian): "JDLB", u32 version, then records of
+//   u32 crc32 (of the rest), f32 time, i32 coins, u32 seed, i64 date
+class Leaderboard {
+public:
+    static constexpr std::size_t TOP_K = 10;
+    static constexpr std::size_t MAX_RUNS = 100000; // compaction keeps the newest runs (and the best) past this
+
+    explicit Leaderboard(std::string logPath);
+    ~Leaderboard();
+
+    Leaderboard(const Leaderboard&) = delete;
+    Leaderboard& operator=(const Leaderboard&) = delete;
+
+    // Reads the log, importing the old highscores.txt / highscore.txt the first time.
+    // Throws std::runtime_error if the log can't be created, or if it isn't a log this
+    // version understands (it is left alone, and add() keeps scores in memory only).
+    void load();
+
+    // Adds the run to the top list and queues it for the log. If load() failed the log
+    // isn't open and the run is only kept in memory; a failed write on the writer thread
+    // is reported on stderr.
+    void add(const RunRecord& run);
+
+    // Best first
+    std::vector<RunRecord> top(std::size_t count) const;
+
+    // Runs in the log; changes whenever add() is called
+    std::size_t runCount() const { return runs; }
+
+private:
+    struct Better {
+        bool operator()(const RunRecord& a, const RunRecord& b) const;
+    };
+
+    void remember(const RunRecord& run);
+    void compact(const std::vector<RunRecord>& keep);
+    void openForAppend();
+    std::vector<RunRecord> importLegacyScores() const;
+    void writeQueued();
+    void stopWriter();
+
+    std::string logPath;
+    int fd = -1;
+    std::size_t runs = 0;
+    std::multiset<RunRecord, Better> best; // at most TOP_K
+
+    // Records waiting for the writer thread, which owns fd while it runs
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::deque<RunRecord> queue;
+    bool stopping = false;
+    std::thread writer;
+};
@@ -0,0 +1,151 @@
+#include "level_generator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "simulation.hpp"
+
+namespace {
+
+// Fraction of the theoretical jump kept as safety margin, for the rounding
+// of variable tick rates and for players who don't press jump at the last pixel
+const float RISE_MARGIN = 0.85f;
+const float REACH_MARGIN = 0.8f;
+
+// SplitMix64: small, fast and defined by its arithmetic alone, so a chunk
+// comes out the same on every platform and standard library
+struct ChunkRng {
+    std::uint64_t state;
+
+    std::uint64_t next() {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [lo, hi)
+    float uniform(float lo, float hi) {
+        return lo + (hi - lo) * float(double(next() >> 11) * (1.0 / 9007199254740992.0));
+    }
+
+    bool chance(float p) { return uniform(0.0f, 1.0f) < p; }
+    int below(int n) { return int(next() % std::uint64_t(n)); }
+};
+
+// Lowest platform top (largest y) platforms are generated at, and the highest
+const float PLATFORM_MIN_Y = 200.0f;
+const float PLATFORM_MAX_Y = GROUND_Y - 80.0f;
+
+void addCoinArc(LevelChunk& chunk, float startX, float surfaceY, int count, float arcHeight) {
+    for (int i = 0; i < count && chunk.coinCount < MAX_CHUNK_COINS; ++i) {
+        // Parabola peaking over the middle coin
+        float t = count > 1 ? float(i) / float(count - 1) * 2.0f - 1.0f : 0.0f;
+        float lift = arcHeight * (1.0f - t * t);
+        chunk.coins[chunk.coinCount++] = {startX + i * 40.0f, surfaceY - COIN_SIZE - 15 - lift, 0};
+    }
+}
+
+} // namespace
+
+float maxJumpRise() {
+    // Integrate exactly like step() does at the reference tick rate
+    float velocity = JUMP_VELOCITY, y = 0.0f, highest = 0.0f;
+    while (velocity < 0.0f) {
+        velocity += GRAVITY;
+        y += velocity;
+        highest = std::min(highest, y);
+    }
+    return -highest;
+}
+
+int jumpAirTicks(float rise) {
+    if (rise > maxJumpRise()) return -1;
+    // Landing needs the feet within 20 px below the platform top while falling
+    float velocity = JUMP_VELOCITY, y = 0.0f;
+    int ticks = 0;
+    while (true) {
+        velocity += GRAVITY;
+        y += velocity;
+        ++ticks;
+        if (velocity >= 0.0f && -y <= rise + 20.0f) return ticks;
+    }
+}
+
+bool canReach(float fromY, float toY, float gap) {
+    float rise = fromY - toY;
+    if (rise > maxJumpRise() * RISE_MARGIN) return false;
+    int ticks = jumpAirTicks(std::max(rise, 0.0f));
+    if (ticks < 0) return false;
+    // The player takes off as the platform edge passes under their left side, and lands
+    // once the next one is under their right side. Checked at the slowest scroll speed.
+    return gap <= FRAME_WIDTH + BASE_SPEED * ticks * REACH_MARGIN;
+}
+
+LevelChunk generateChunk(std::uint64_t seed, int index, float platformWidth) {
+    LevelChunk chunk;
+    chunk.seed = seed;
+    chunk.index = index;
+    ChunkRng rng{seed ^ (std::uint64_t(index) * 0xD1B54A32D192ED03ull)};
+
+    // --- Platforms, left to right, each one reachable from the ground or the previous one ---
+    float cursor = 150.0f;
+    const ChunkSpawn* previous = nullptr;
+    while (chunk.platformCount < MAX_CHUNK_PLATFORMS) {
+        float gap = rng.uniform(120.0f, 380.0f);
+        float x = previous ? cursor + gap : cursor;
+        if (x + platformWidth > CHUNK_WIDTH) break;
+
+        float y = PLATFORM_MAX_Y;
+        bool placed = false;
+        for (int attempt = 0; attempt < 8 && !placed; ++attempt) {
+            y = rng.uniform(PLATFORM_MIN_Y, PLATFORM_MAX_Y);
+            placed = canReach(GROUND_Y, y, 0.0f) || (previous && canReach(previous->y, y, gap));
+        }
+        if (!placed) y = std::max(y, GROUND_Y - maxJumpRise() * RISE_MARGIN);
+
+        chunk.platforms[chunk.platformCount] = {x, y, 0};
+        previous = &chunk.platforms[chunk.platformCount++];
+        cursor = x + platformWidth;
+    }
+
+    // --- Coin arcs over platforms, and low ones over the ground between them ---
+    const float arcLimit = maxJumpRise() * 0.5f;
+    for (int i = 0; i < chunk.platformCount; ++i) {
+        const ChunkSpawn& p = chunk.platforms[i];
+        if (rng.chance(0.6f)) {
+            int count = 3 + rng.below(3);
+            float startX = p.x + rng.uniform(10.0f, std::max(10.0f, platformWidth - count * 40.0f));
+            addCoinArc(chunk, startX, p.y, count, rng.uniform(0.0f, arcLimit));
+        }
+        if (rng.chance(0.35f)) {
+            float startX = p.x - rng.uniform(120.0f, 200.0f);
+            if (startX > 0.0f) addCoinArc(chunk, startX, GROUND_Y, 3, rng.uniform(0.0f, arcLimit));
+        }
+    }
+
+    // --- Obstacle patterns. The first chunk is left clear while the run warms up. ---
+    if (index > 0) {
+        float nextFree = 200.0f; // keep obstacles apart so each one can be jumped on its own
+        int patterns = 1 + rng.below(3);
+        for (int n = 0; n < patterns && chunk.obstacleCount < MAX_CHUNK_OBSTACLES; ++n) {
+            float x = nextFree + rng.uniform(0.0f, 400.0f);
+            if (x > CHUNK_WIDTH - 100.0f) break;
+
+            int pattern = rng.below(3);
+            if (pattern == 0 && chunk.platformCount > 0) {
+                // Obstacle1 sitting on a platform
+                const ChunkSpawn& p = chunk.platforms[rng.below(chunk.platformCount)];
+                x = p.x + rng.uniform(20.0f, std::max(20.0f, platformWidth - 60.0f));
+                chunk.obstacles[chunk.obstacleCount++] = {x, p.y - OBSTACLE_SIZE, 1};
+            } else if (pattern == 1) {
+                // Obstacle2 only on the ground
+                chunk.obstacles[chunk.obstacleCount++] = {x, GROUND_Y - OBSTACLE_SIZE, 2};
+            } else {
+                chunk.obstacles[chunk.obstacleCount++] = {x, GROUND_Y - OBSTACLE_SIZE, 1};
+            }
+            nextFree = std::max(nextFree, x + 450.0f);
+        }
+    }
+    return chunk;
+}
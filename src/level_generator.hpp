@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+
+// Seeded procedural level generation.
+//
+// The level is cut into fixed-width chunks. A chunk depends only on (seed, index),
+// so it can be generated ahead of time on any thread and still come out identical.
+// Every platform is checked against the player's jump arc (from GRAVITY and
+// JUMP_VELOCITY) so it can be reached from the ground or from the platform before it.
+
+const float CHUNK_WIDTH = 1800.0f;
+const int MAX_CHUNK_PLATFORMS = 8;
+const int MAX_CHUNK_COINS = 48;
+const int MAX_CHUNK_OBSTACLES = 6;
+
+struct ChunkSpawn {
+    float x, y;        // x is relative to the chunk's left edge
+    std::uint8_t type; // obstacle type (1 or 2), unused for platforms and coins
+};
+
+// Plain data, so chunks can be copied through a lock-free queue
+struct LevelChunk {
+    std::uint64_t seed = 0;
+    int index = -1;
+    int platformCount = 0;
+    int coinCount = 0;
+    int obstacleCount = 0;
+    ChunkSpawn platforms[MAX_CHUNK_PLATFORMS];
+    ChunkSpawn coins[MAX_CHUNK_COINS];
+    ChunkSpawn obstacles[MAX_CHUNK_OBSTACLES];
+};
+
+LevelChunk generateChunk(std::uint64_t seed, int index, float platformWidth);
+
+// Jump arc helpers, from the same per-tick integration the simulation uses
+float maxJumpRise();                  // how far the player's feet rise in a full jump
+int jumpAirTicks(float rise);         // ticks from take-off to landing `rise` pixels higher, -1 if out of reach
+bool canReach(float fromY, float toY, float gap); // surface top at fromY -> platform top at toY, gap pixels ahead
+
+// Supplies chunks generated ahead of time. step() generates synchronously whenever
+// the source has nothing ready, so results never depend on thread timing.
+class ChunkSource {
+public:
+    virtual ~ChunkSource() = default;
+    // Fills chunk and returns true if (seed, index) was ready
+    virtual bool take(std::uint64_t seed, int index, LevelChunk& chunk) = 0;
+};
@@ -0,0 +1,90 @@
+#include "level_streamer.hpp"
+
+
+LevelStreamer::LevelStreamer(float platformWidth_)
+    : platformWidth(platformWidth_), worker(&LevelStreamer::run, this) {}
+
+LevelStreamer::~LevelStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        running = false;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void LevelStreamer::restart(std::uint64_t seed, int firstIndex) {
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        request.seed = seed;
+        request.index = firstIndex;
+        request.generation++;
+    }
+    wake.notify_one();
+    while (queue.front()) queue.pop(); // stale; take() skips any the worker still pushes
+    expectedSeed = seed;
+    expectedIndex = firstIndex;
+}
+
+void LevelStreamer::wakeWorker() {
+    // Through the mutex, so the worker is either still checking or already waiting
+    { std::lock_guard<std::mutex> lock(requestMutex); }
+    wake.notify_one();
+}
+
+bool LevelStreamer::take(std::uint64_t seed, int index, LevelChunk& chunk) {
+    if (seed != expectedSeed || index != expectedIndex) {
+        // New run, or the world jumped; point the worker at the chunk after this one
+        restart(seed, index + 1);
+        ++missCount;
+        return false;
+    }
+    expectedIndex = index + 1;
+
+    // Skip anything left over from an earlier request
+    bool popped = false;
+    bool found = false;
+    while (LevelChunk* front = queue.front()) {
+        if (front->seed == seed && front->index == index) {
+            chunk = *front;
+            queue.pop();
+            popped = found = true;
+            break;
+        }
+        if (front->seed == seed && front->index > index) break;
+        queue.pop();
+        popped = true;
+    }
+    if (popped) wakeWorker(); // there is room for another one
+    if (!found) ++missCount;
+    return found;
+}
+
+void LevelStreamer::run() {
+    unsigned generation = 0;
+    std::uint64_t seed = 0;
+    int index = 0;
+    bool active = false;
+    LevelChunk chunk;
+
+    while (running.load(std::memory_order_relaxed)) {
+        {
+            // Nothing to do until the simulation restarts or catches up
+            std::unique_lock<std::mutex> lock(requestMutex);
+            wake.wait(lock, [&] {
+                return !running.load(std::memory_order_relaxed) || request.generation != generation ||
+                       (active && !queue.full());
+            });
+            if (!running.load(std::memory_order_relaxed)) break;
+            if (request.generation != generation) {
+                generation = request.generation;
+                seed = request.seed;
+                index = request.index;
+                active = true;
+            }
+        }
+        chunk = generateChunk(seed, index, platformWidth);
+        queue.push(chunk);
+        ++index;
+    }
+}
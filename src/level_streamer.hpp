@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "level_generator.hpp"
+#include "spsc_queue.hpp"
+
+// Generates level chunks ahead of the camera on a worker thread.
+// The worker pushes finished chunks into a lock-free queue; the simulation pops them
+// without blocking. If the chunk it needs isn't there yet (or the run was restarted
+// with a new seed), take() says so and the simulation generates it itself.
+// With nothing requested or the queue full, the worker sleeps until a restart or a take().
+class LevelStreamer : public ChunkSource {
+public:
+    explicit LevelStreamer(float platformWidth);
+    ~LevelStreamer() override;
+
+    LevelStreamer(const LevelStreamer&) = delete;
+    LevelStreamer& operator=(const LevelStreamer&) = delete;
+
+    bool take(std::uint64_t seed, int index, LevelChunk& chunk) override;
+
+    // Chunks the simulation had to generate itself because the worker was behind
+    long misses() const { return missCount; }
+
+private:
+    static constexpr std::size_t AHEAD = 4; // chunks generated in advance
+
+    void run();
+    void restart(std::uint64_t seed, int firstIndex);
+    void wakeWorker();
+
+    float platformWidth;
+    SpscQueue<LevelChunk, AHEAD> queue;
+
+    // Where the worker should (re)start; generation tells it a new request is there.
+    // Written and read together under the mutex, so the worker never mixes two restarts.
+    struct Request {
+        std::uint64_t seed = 0;
+        int index = 0;
+        unsigned generation = 0;
+    };
+    std::mutex requestMutex;
+    std::condition_variable wake; // a new request, a chunk taken, or shutdown
+    Request request;
+    std::atomic<bool> running{true};
+
+    // Consumer side: the chunk the worker is expected to deliver next
+    std::uint64_t expectedSeed = 0;
+    int expectedIndex = -1;
+    long missCount = 0;
+
+    std::thread worker;
+};
@@ -1,6 +1,8 @@
 #include<cstdint>
+#include <iostream>
 #include<string>
 #include<cstring> //For memcpy,memmove
+#include <ctime>
 #include <fstream>
 #include <algorithm>
 #include <SFML/Audio.hpp>
@@ -10,223 +12,239 @@
 #include <random>
 #include <sstream>
 
-const int WINDOW_WIDTH = 900;
-const int WINDOW_HEIGHT = 600;
-const int GROUND_Y = 500;
-const float GRAVITY = 0.3f; // Reduced from 0.5f to 0.3f for lighter gravity
-
-const int PLATFORM_WIDTH = 180;
-const int PLATFORM_HEIGHT = 30;
-const int COIN_SIZE = 32;
-const int OBSTACLE_SIZE = 40; // Increased from 32 to 40 for slightly taller obstacles
-const int LIFE_ICON_SIZE = 32;
-const int MAX_LIVES = 3;
+#include "alloc_tracker.hpp"
+#include "asset_loader.hpp"
+#include "asset_pack.hpp"
+#include "batch_runner.hpp"
+#include "config.hpp"
+#include "frame_arena.hpp"
+#include "frame_pacer.hpp"
+#include "frame_profiler.hpp"
+#include "game_scene.hpp"
+#include "headless.hpp"
+#include "hud.hpp"
+#include "idle_screen.hpp"
+#include "leaderboard.hpp"
+#include "level_streamer.hpp"
+#include "profiler_overlay.hpp"
+#include "render_bench.hpp"
+#include "replay.hpp"
+#include "sim_thread.hpp"
+#include "simulation.hpp"
+#include "sound_pool.hpp"
 
 enum class GameState { MENU, PLAYING, PAUSED, GAME_OVER, HIGH_SCORE };
-struct Platform {
-    sf::Sprite sprite;
-    float x, y;
-    Platform(const sf::Texture& tex, float x_, float y_)
-        : sprite(tex), x(x_), y(y_) {
-        sprite.setPosition(x, y);
-    }
-};
-
-std::vector<Platform> platforms;
-
-int main() {
-    sf::RenderWindow window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), "Jump & Dodge");
-    window.setFramerateLimit(60);
-
-    // Load Textures
-    sf::Texture playerTexture;
-    if (!playerTexture.loadFromFile("assets/player_spritesheet.png")) {
-        throw std::runtime_error("Failed to load player sprite sheet!");
-    }
-
-    sf::Texture cloudTexture;
-    if (!cloudTexture.loadFromFile("assets/cloud.png")) {
-        throw std::runtime_error("Failed to load cloud texture!");
-    }
-
-    // --- Add this for the background image ---
-    sf::Texture backgroundTexture;
-    if (!backgroundTexture.loadFromFile("assets/background.jpg")) {
-        throw std::runtime_error("Failed to load background image!");
-    }
-
-        // ADD GROUND TEXTURE HERE (after line 84)
-    sf::Texture groundTexture;
-    if (!groundTexture.loadFromFile("assets/ground.png")) {
-        throw std::runtime_error("Failed to load ground texture!");
-    }
-    sf::Sprite backgroundSprite(backgroundTexture);
-    backgroundSprite.setScale(
-        float(WINDOW_WIDTH) / backgroundTexture.getSize().x,
-        float(WINDOW_HEIGHT) / backgroundTexture.getSize().y
-    );
-    // --- End background image addition ---
-
-    // Animation setup
-    const int FRAME_WIDTH = 1773 / 12;   // 75
-    const int FRAME_HEIGHT = 150;      // 365
-    const int FRAME_COUNT = 8;     // number of frames
-    int currentFrame = 0;
-    float animationTimer = 0.0f;
-    const float FRAME_DURATION = 0.05f; // seconds per frame
-
-    //Player setup
-    sf::Sprite playerSprite;
-    playerSprite.setTexture(playerTexture);
-    playerSprite.setTextureRect(sf::IntRect(0, 0, FRAME_WIDTH, FRAME_HEIGHT));
-    playerSprite.setPosition(100, GROUND_Y - FRAME_HEIGHT); // Correct Y position
-    float playerVelocityY = 0;
-    bool isJumping = false;
-
-    //Background ground - Replace rectangle with sprite
-    sf::Sprite groundSprite(groundTexture);
-    groundSprite.setPosition(0, GROUND_Y);
-    // Scale the ground image to fit the area (900x100 pixels)
-    groundSprite.setScale(
-        float(WINDOW_WIDTH) / groundTexture.getSize().x,
-        100.0f / groundTexture.getSize().y
-    );
 
-    //Cloud setup
-    std::vector<sf::Sprite> clouds;
-    for (int i = 0; i < 3; ++i) {
-        sf::Sprite cloud;
-        cloud.setTexture(cloudTexture); // <-- Use the correct texture here!
-        cloud.setPosition(200 + i * 250, 80 + (i % 2) * 40);
-        clouds.push_back(cloud);
+int main(int argc, char* argv[]) {
+    // --- Command line ---
+    // --headless [seconds] [--seed N] runs the simulation without a window
+    // --tick-rate N sets the fixed simulation rate (Hz, up to 1000), --fps N the render rate (0 = uncapped)
+    // --pacing vsync|spin|uncapped|fixed picks how frames are paced (F4 cycles them in game)
+    // --stress N adds N extra coins and obstacles to every run
+    // --classic-level uses the original recycled platforms instead of the streamed level
+    // --profile-csv FILE writes per-frame phase timings (F3 shows them in game)
+    // --replay FILE plays a recorded run (every finished run is saved to last_run.replay);
+    //   --replay-speed N plays it N times faster, with --headless as fast as possible
+    // --difficulty "name=value ..." overrides the difficulty curve (see batch_runner.hpp)
+    // --batch [FILE] plays --batch-runs N bot runs per difficulty set in FILE (one per line,
+    //   default: just the current one) on every core and prints the distributions;
+    //   --batch-csv FILE also writes every run, --batch-threads N limits the threads (default all cores)
+    // --practice lets Backspace rewind the last seconds and Enter restart the level (no leaderboard;
+    //   not with --stress above 1000)
+    // --alloc-check reports steady-state frames that allocate, and exits with 3 if there were any
+    //   (needs the make alloc-check build, which counts allocations)
+    // --render-bench [frames] draws a bot run offscreen and prints frames/s and draw calls
+    //   (--seed picks the run, default 1); --golden DIR compares --golden-frames "60,300,..."
+    //   with DIR/frame_N.png (--golden-tolerance N per channel), --update-golden rewrites them
+    bool headless = false;
+    SimConfig simConfig;
+    unsigned int framerateLimit = 60;
+    PacingMode pacingMode = PacingMode::SleepSpin;
+    float headlessSeconds = 3600.0f;
+    std::random_device rd;
+    unsigned int seed = rd();
+    std::string profileCsvPath;
+    std::string replayPath;
+    float replaySpeed = 1.0f;
+    bool practice = false;
+    bool allocCheck = false;
+    bool seedSet = false;
+    bool renderBench = false;
+    RenderBenchOptions renderOptions;
+    bool batch = false;
+    std::string batchSetsPath;
+    BatchOptions batchOptions;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--headless") {
+            headless = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') headlessSeconds = std::stof(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<unsigned int>(std::stoul(argv[++i]));
+            seedSet = true;
+        } else if (arg == "--tick-rate" && i + 1 < argc) {
+            simConfig.tickSeconds = 1.0f / std::clamp(std::stof(argv[++i]), 1.0f, MAX_TICK_RATE);
+        } else if (arg == "--fps" && i + 1 < argc) {
+            // 0 picks uncapped; the paced modes (F4) keep their default rate
+            unsigned int fps = static_cast<unsigned int>(std::stoul(argv[++i]));
+            if (fps == 0) {
+                pacingMode = PacingMode::Uncapped;
+            } else {
+                framerateLimit = fps;
+            }
+        } else if (arg == "--pacing" && i + 1 < argc) {
+            if (!parsePacingMode(argv[++i], pacingMode)) {
+                throw std::runtime_error(std::string("Unknown pacing mode ") + argv[i]);
+            }
+        } else if (arg == "--stress" && i + 1 < argc) {
+            simConfig.stressEntities = std::clamp(std::stoi(argv[++i]), 0, MAX_STRESS_ENTITIES);
+        } else if (arg == "--classic-level") {
+            simConfig.levelMode = LevelMode::Recycled;
+        } else if (arg == "--profile-csv" && i + 1 < argc) {
+            profileCsvPath = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (arg == "--replay-speed" && i + 1 < argc) {
+            replaySpeed = std::max(0.1f, std::stof(argv[++i]));
+        } else if (arg == "--difficulty" && i + 1 < argc) {
+            parseDifficulty(argv[++i], simConfig.difficulty);
+        } else if (arg == "--practice") {
+            practice = true;
+        } else if (arg == "--alloc-check") {
+            allocCheck = true;
+        } else if (arg == "--render-bench") {
+            renderBench = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') renderOptions.frames = std::stoi(argv[++i]);
+        } else if (arg == "--golden" && i + 1 < argc) {
+            renderOptions.goldenDirectory = argv[++i];
+        } else if (arg == "--update-golden") {
+            renderOptions.updateGolden = true;
+        } else if (arg == "--golden-frames" && i + 1 < argc) {
+            renderOptions.checkFrames = parseFrameList(argv[++i]);
+        } else if (arg == "--golden-tolerance" && i + 1 < argc) {
+            renderOptions.tolerance = std::stoi(argv[++i]);
+        } else if (arg == "--batch") {
+            batch = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') batchSetsPath = argv[++i];
+        } else if (arg == "--batch-runs" && i + 1 < argc) {
+            batchOptions.runsPerSet = std::stoi(argv[++i]);
+        } else if (arg == "--batch-csv" && i + 1 < argc) {
+            batchOptions.csvPath = argv[++i];
+        } else if (arg == "--batch-threads" && i + 1 < argc) {
+            batchOptions.threads = std::stoi(argv[++i]);
+        }
     }
-
-    // Load additional textures
-    sf::Texture platformTexture;
-    if (!platformTexture.loadFromFile("assets/platform.png")) {
-        throw std::runtime_error("Failed to load platform texture!");
+    if (practice && simConfig.stressEntities > MAX_PRACTICE_STRESS_ENTITIES) {
+        std::cerr << "--practice copies the whole world every tick; use --stress " << MAX_PRACTICE_STRESS_ENTITIES
+                  << " or less with it" << std::endl;
+        return 1;
     }
-    sf::Texture coinTexture;
-    if (!coinTexture.loadFromFile("assets/coin.png")) {
-        throw std::runtime_error("Failed to load coin texture!");
+    if (allocCheck && !ALLOCATION_TRACKING) {
+        std::cerr << "--alloc-check needs a build that counts allocations (make alloc-check)" << std::endl;
+        return 1;
     }
-    sf::Texture obstacle1Texture;
-    if (!obstacle1Texture.loadFromFile("assets/obstacle1.png")) {
-        throw std::runtime_error("Failed to load obstacle1 texture!");
+    if (batch) {
+        batchOptions.seed = seed;
+        std::vector<DifficultyParams> sets{simConfig.difficulty};
+        if (!batchSetsPath.empty()) sets = loadDifficultySets(batchSetsPath);
+        return runBatch(sets, simConfig, batchOptions);
     }
-    sf::Texture obstacle2Texture;
-    if (!obstacle2Texture.loadFromFile("assets/obstacle2.png")) {
-        throw std::runtime_error("Failed to load obstacle2 texture!");
+    Replay playback;
+    const bool replaying = !replayPath.empty();
+    if (replaying) playback = loadReplay(replayPath);
+    if (headless) {
+        if (replaying) return runReplay(playback);
+        return runHeadless(headlessSeconds, seed, simConfig);
     }
-    sf::Texture lifeTexture;
-    if (!lifeTexture.loadFromFile("assets/life.png")) {
-        throw std::runtime_error("Failed to load life texture!");
+    if (renderBench) {
+        if (seedSet) renderOptions.seed = seed;
+        AssetPack pack;
+        pack.open("assets.pak");
+        AssetLoader loader(pack);
+        return runRenderBench(loader.get(), simConfig, renderOptions);
     }
 
-    // --- Platforms setup ---
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> xDist(150, WINDOW_WIDTH - PLATFORM_WIDTH - 50);
-    std::uniform_real_distribution<float> yDist(200, GROUND_Y - 80);
-
-    std::vector<Platform> platforms;
-    for (int i = 0; i < 5; ++i) {
-        float randX = xDist(gen) + i * 120; // Spread out a bit horizontally
-        float randY = yDist(gen);
-        platforms.emplace_back(platformTexture, randX, randY);
-        platforms.back().sprite.setPosition(randX, randY);
-    }
+    sf::RenderWindow window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), "Jump & Dodge");
 
-    // --- Coins setup ---
-    struct Coin {
-        sf::Sprite sprite;
-        bool collected = false;
-        Coin(const sf::Texture& tex, bool collected_ = false) : sprite(tex), collected(collected_) {}
-    };
-    std::vector<Coin> coins = {
-        {coinTexture, false}, {coinTexture, false}, {coinTexture, false},
-        {coinTexture, false}, {coinTexture, false}
-    };
-    // Place coins just above platforms or ground (different positions from obstacles)
-    coins[0].sprite.setPosition(platforms[0].x + 20, platforms[0].y - COIN_SIZE - 15); // Left side
-    coins[1].sprite.setPosition(platforms[1].x + 130, platforms[1].y - COIN_SIZE - 15); // Right side
-    coins[2].sprite.setPosition(platforms[2].x + 20, platforms[2].y - COIN_SIZE - 15); // Left side
-    coins[3].sprite.setPosition(platforms[3].x + 130, platforms[3].y - COIN_SIZE - 15); // Right side
-    coins[4].sprite.setPosition(650, GROUND_Y - COIN_SIZE - 15); // Ground coin - different position
-
-    // --- Obstacles setup ---
-    struct Obstacle {
-        sf::Sprite sprite;
-        int type; // 1 or 2
-        bool visible = true;
-        Obstacle(const sf::Texture& tex, int type_) : sprite(tex), type(type_), visible(true) {}
+    // --- Frame pacing ---
+    FramePacer pacer(pacingMode, framerateLimit);
+    auto applyPacing = [&]() {
+        window.setVerticalSyncEnabled(pacer.mode() == PacingMode::VSync);
+        window.setFramerateLimit(pacer.mode() == PacingMode::Fixed ? pacer.rate() : 0);
     };
-    std::vector<Obstacle> obstacles = {
-        {obstacle1Texture, 1}, {obstacle2Texture, 2}, {obstacle1Texture, 1},
-        {obstacle2Texture, 2}
+    applyPacing();
+    // Every frame goes out through here, so each mode's intervals are measured the same way
+    auto present = [&]() {
+        pacer.wait();
+        window.display();
+        pacer.presented();
     };
-    // Place obstacles on platforms or ground (starting off-screen)
-    obstacles[0].sprite.setPosition(WINDOW_WIDTH + 300, platforms[0].y - OBSTACLE_SIZE); // obstacle1 on platform 1
-    obstacles[1].sprite.setPosition(WINDOW_WIDTH + 600, GROUND_Y - OBSTACLE_SIZE); // obstacle2 on ground only
-    obstacles[2].sprite.setPosition(WINDOW_WIDTH + 900, platforms[2].y - OBSTACLE_SIZE); // obstacle1 on platform 3
-    obstacles[3].sprite.setPosition(WINDOW_WIDTH + 1200, GROUND_Y - OBSTACLE_SIZE); // obstacle2 on ground only
-    
-    // Ensure obstacles are scaled properly if needed
-    for (auto& obs : obstacles) {
-        if (obs.type == 2) {
-            // Make obstacle2 (type 2) a bit larger (e.g., 1.3x)
-            obs.sprite.setScale(
-                1.3f * float(OBSTACLE_SIZE) / obs.sprite.getTexture()->getSize().x,
-                1.3f * float(OBSTACLE_SIZE) / obs.sprite.getTexture()->getSize().y
-            );
-        } else {
-            // Default scaling for obstacle1
-            obs.sprite.setScale(
-                float(OBSTACLE_SIZE) / obs.sprite.getTexture()->getSize().x,
-                float(OBSTACLE_SIZE) / obs.sprite.getTexture()->getSize().y
-            );
+    window.setKeyRepeatEnabled(false); // a held Space is one press, not a stream of them
+
+    // --- Assets ---
+    // Everything comes from one memory-mapped assets.pak (built by `make pack`),
+    // or from the loose files in assets/ when there is no pack.
+    AssetPack pack;
+    pack.open("assets.pak");
+
+    // Decode on worker threads while the main thread draws a loading bar
+    AssetLoader loader(pack);
+    sf::RectangleShape loadingBarBack(sf::Vector2f(400, 20));
+    loadingBarBack.setFillColor(sf::Color(50, 50, 50));
+    loadingBarBack.setPosition(WINDOW_WIDTH / 2 - 200, WINDOW_HEIGHT / 2 - 10);
+    sf::RectangleShape loadingBarFill(sf::Vector2f(0, 20));
+    loadingBarFill.setFillColor(sf::Color::White);
+    loadingBarFill.setPosition(WINDOW_WIDTH / 2 - 200, WINDOW_HEIGHT / 2 - 10);
+    while (!loader.isDone()) {
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed)
+                window.close();
         }
+        if (!window.isOpen()) return 0;
+
+        loadingBarFill.setSize(sf::Vector2f(400 * loader.progress(), 20));
+        window.clear(sf::Color(100, 149, 237)); // sky blue
+        window.draw(loadingBarBack);
+        window.draw(loadingBarFill);
+        present();
     }
+    LoadedAssets& assets = loader.get();
 
-    // --- Life icons ---
-    std::vector<sf::Sprite> lifeIcons(MAX_LIVES, sf::Sprite(lifeTexture));
-    for (int i = 0; i < MAX_LIVES; ++i)
-        lifeIcons[i].setPosition(10 + i * (LIFE_ICON_SIZE + 5), 10);
+    // --- Game scene: sprite atlas, parallax layers and HUD ---
+    GameScene scene(assets);
 
-    int lives = MAX_LIVES;
-    int coinCount = 0;
-    sf::Clock gameClock;
-    float gameSpeed = 1.0f; // Base speed multiplier
-    const float baseSpeed = 2.34f * 1.5f; // 1.5x faster initial speed
-    static float gameEndTime = 0.0f; // Move this declaration here
+    // --- Add this for the background image ---
+    sf::Sprite backgroundSprite(scene.background());
+    backgroundSprite.setScale(
+        float(WINDOW_WIDTH) / scene.background().getSize().x,
+        float(WINDOW_HEIGHT) / scene.background().getSize().y
+    );
+    // --- End background image addition ---
+
+    SimConfig gameConfig = simConfig;
+    scene.applySizes(gameConfig);
+
+    // Level chunks are generated ahead of the camera on a worker thread
+    LevelStreamer levelStreamer(gameConfig.platformWidth);
+
+    // The simulation ticks on its own thread; this one only handles events and draws
+    // the latest snapshot it publishes
+    SimulationThread sim(gameConfig, &levelStreamer, replaying ? &playback : nullptr, replaySpeed, practice);
 
     // --- Font for UI ---
-    sf::Font font;
-    if (!font.loadFromFile("assets/arial.ttf")) {
-        throw std::runtime_error("Failed to load font!");
-    }
-    sf::Text scoreText, coinText, gameOverText, restartText;
-    scoreText.setFont(font);
-    scoreText.setCharacterSize(24);
-    scoreText.setFillColor(sf::Color::White);
-    coinText.setFont(font);
-    coinText.setCharacterSize(24);
-    coinText.setFillColor(sf::Color::Yellow);
-    gameOverText.setFont(font);
-    gameOverText.setCharacterSize(48);
-    gameOverText.setFillColor(sf::Color::Red);
-    gameOverText.setString("GAME OVER");
-    gameOverText.setPosition(WINDOW_WIDTH / 2 - 120, WINDOW_HEIGHT / 2 - 60);
-    restartText.setFont(font);
-    restartText.setCharacterSize(24);
-    restartText.setFillColor(sf::Color::White);
-    restartText.setString("Press R to Restart");
-    restartText.setPosition(WINDOW_WIDTH / 2 - 80, WINDOW_HEIGHT / 2 - 10);
+    const sf::Font& font = assets.font;
 
     // --- BGM setup ---
     sf::Music bgm1, bgm2;
-    bool bgm1Loaded = bgm1.openFromFile("assets/bgm1.ogg"); // Place your BGM at assets/bgm.ogg
-    bool bgm2Loaded = bgm2.openFromFile("assets/bgm2.ogg"); // Place your BGM at assets/bgm.ogg
+    // Music streams from the pack's memory while it plays, so it isn't decoded up front
+    auto openMusic = [&](sf::Music& music, const std::string& name) {
+        if (!pack.contains(name)) return false;
+        AssetData file = pack.get(name);
+        return music.openFromMemory(file.data, file.size);
+    };
+    bool bgm1Loaded = openMusic(bgm1, "bgm1.ogg"); // Place your BGM at assets/bgm1.ogg
+    bool bgm2Loaded = openMusic(bgm2, "bgm2.ogg"); // Place your BGM at assets/bgm2.ogg
     bgm1.setLoop(true);
     bgm2.setLoop(true);
     bgm1.play(); // Always playing
@@ -236,7 +254,7 @@ int main() {
     sf::Texture logoTexture;
     sf::Sprite logoSprite;
     bool logoLoaded = false;
-    if (logoTexture.loadFromFile("assets/logo.png")) { // Place your logo at assets/logo.png
+    if (assets.logoLoaded && logoTexture.loadFromImage(assets.logo)) { // Place your logo at assets/logo.png
         logoSprite.setTexture(logoTexture);
         // Scale and position the logo as needed
         float logoScale = 0.4f; // Adjust as needed
@@ -304,479 +322,369 @@ int main() {
     backText.setPosition(WINDOW_WIDTH - 95, 28);
     // --- End back button ---
 
-    bool gameOver = false;
+    // --- High score screen text, laid out once ---
+    sf::Text hsTitle("HIGH SCORES", font, 40);
+    hsTitle.setFillColor(sf::Color::Black);
+    hsTitle.setPosition(WINDOW_WIDTH / 2 - hsTitle.getLocalBounds().width / 2, 120);
+
+    sf::Text escHint("Press ESC to return", font, 24);
+    escHint.setFillColor(sf::Color::Black);
+    escHint.setPosition(WINDOW_WIDTH / 2 - 100, 400);
+
+    std::vector<sf::Text> scoreLines;  // rebuilt only when the scores change
+    std::size_t shownRunCount = std::size_t(-1);
+
+    // --- Idle rendering ---
+    // The menu, pause and high score screens are drawn once into a texture and shown from
+    // there; while one is up the loop sleeps until input arrives instead of redrawing.
+    IdleScreen idleScreen(WINDOW_WIDTH, WINDOW_HEIGHT);
+    bool idleShown = false; // the last frame was an idle screen, so the next one can wait
+    auto presentIdle = [&]() {
+        window.display(); // not paced: it already waited for input
+        pacer.idle();
+        idleShown = true;
+    };
+
+    // --- Glyph cache prewarm ---
+    // Rasterize the glyphs every UI text needs (plus digits for the high scores) now,
+    // so no frame stalls rendering a character for the first time (GameScene does its own)
+    const std::string numberGlyphs = "0123456789.: ";
+    for (const sf::Text* text : {&titleText, &startText, &resumeText, &restartMenuText,
+                                 &mainMenuText, &highScoreText, &backText, &hsTitle, &escHint}) {
+        prewarmGlyphs(*text, numberGlyphs); // startText's size also covers the high score lines
+    }
 
     GameState gameState = GameState::MENU;
 
     // High Scores
-    std::vector<int> highScores = {0, 0, 0}; // Always start with three zeros
-
-    // Load high scores from file (if file doesn't exist, keep zeros)
-    auto loadHighScores = [&]() {
-        std::ifstream fin("assets/highscores.txt");
-        int score, i = 0;
-        while (fin >> score && i < 3) {
-            highScores[i++] = score;
-        }
-        // If less than 3 scores in file, fill the rest with 0
-        for (; i < 3; ++i) highScores[i] = 0;
-    };
-
-    // Save high scores to file
-    auto saveHighScores = [&]() {
-        std::ofstream fout("assets/highscores.txt");
-        for (int s : highScores) fout << s << std::endl;
-    };
+    // Every finished run goes into the leaderboard log; the screen shows the best three
+    Leaderboard leaderboard("leaderboard.log");
+    try {
+        leaderboard.load();
+    } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << std::endl; // play on; scores are kept for this session only
+    }
 
-    // Call once at start
-    loadHighScores();
 
-    // --- Coin sound setup ---
-    sf::SoundBuffer coinBuffer;
-    if (!coinBuffer.loadFromFile("assets/coin.wav")) {
-        throw std::runtime_error("Failed to load coin sound!");
+    // --- Sound effects ---
+    // Voices are allocated here; quick pickups overlap instead of cutting each other off.
+    // The pool is smaller than all the effects' voices together, so a hit or the game over
+    // sound during a burst of pickups steals the oldest coin voice rather than being dropped.
+    SoundPool sfx(6);
+    SoundEffectSettings coinSettings;
+    coinSettings.voices = 6;
+    coinSettings.pitchVariation = 0.06f;
+    coinSettings.volumeVariation = 0.1f;
+    const std::size_t coinSound = sfx.addEffect(assets.coinBuffer, coinSettings);
+
+    SoundEffectSettings obsSettings;
+    obsSettings.voices = 2;
+    obsSettings.priority = 1;
+    obsSettings.pitchVariation = 0.03f;
+    const std::size_t obsSound = sfx.addEffect(assets.obsBuffer, obsSettings);
+
+    SoundEffectSettings gameOverSettings;
+    gameOverSettings.priority = 2; // never dropped
+    const std::size_t gameOverSound = sfx.addEffect(assets.gameOverBuffer, gameOverSettings);
+
+    // Every way of starting a run (Start, pause-menu Restart, R after game over) goes through here.
+    // --seed picks the first run's level, later runs get a fresh seed. The simulation thread
+    // records every run and saves it when it ends, so a reported death can be replayed exactly.
+    unsigned int nextSeed = seed;
+    auto startNewRun = [&]() {
+        sim.startRun(nextSeed);
+        nextSeed = rd();
+    };
+    if (replaying) {
+        sim.startReplay();
+        gameState = GameState::PLAYING;
+        if (bgm2Loaded) bgm2.play();
     }
-    sf::Sound coinSound;
-    coinSound.setBuffer(coinBuffer);
 
-    // --- Obstacle hit sound setup ---
-    sf::SoundBuffer obsBuffer;
-    if (!obsBuffer.loadFromFile("assets/obs.wav")) {
-        throw std::runtime_error("Failed to load obstacle sound!");
-    }
-    sf::Sound obsSound;
-    obsSound.setBuffer(obsBuffer);
+    // Totals from the last snapshot looked at, to tell which sounds to play
+    std::uint64_t seenCoinPickups = 0, seenObstacleHits = 0, seenGameOvers = 0;
+    std::uint64_t seenPressedJumps = 0;
 
-    // --- Game over sound setup ---
-    sf::SoundBuffer gameOverBuffer;
-    if (!gameOverBuffer.loadFromFile("assets/gameover.wav")) {
-        throw std::runtime_error("Failed to load game over sound!");
-    }
-    sf::Sound gameOverSound;
-    gameOverSound.setBuffer(gameOverBuffer);
+    // Fixed timestep: the simulation thread always advances in tickSeconds steps,
+    // rendering happens whenever it can and blends between the last two ticks.
 
-    static bool gameOverSoundPlayed = false; // Ensuring this is at the top of main() or just before the main game loop
+    // --- Frame profiler (F3 toggles the overlay) ---
+    FrameProfiler profiler;
+    if (!profileCsvPath.empty() && !profiler.openCsv(profileCsvPath)) {
+        throw std::runtime_error("Failed to open profile CSV " + profileCsvPath);
+    }
+    ProfilerOverlay profilerOverlay(font);
+    bool showProfiler = false;
+
+    // --- Per-frame memory ---
+    // Temporaries go in the frame arena, which is emptied at the top of every frame.
+    // Once the game has settled, a frame should not touch the heap at all; the check
+    // counts the main thread's allocations per frame and flags the ones that do.
+    FrameArena frameArena(64 * 1024);
+    FrameAllocationCheck allocationCheck(allocCheck);
+    GameState settledState = gameState;
+    std::uint64_t settledRuns = 0, settledGameOvers = 0;
+    bool settledShowProfiler = showProfiler;
 
     while (window.isOpen()) {
+        // On an idle screen nothing changes until an event (or the refresh timer)
+        // The wait itself belongs to no frame, so the last one is closed before it.
         sf::Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed)
-                window.close();
+        bool waited = false;
+        if (idleShown) {
+            profiler.endFrame();
+            allocationCheck.endFrame();
+            waited = IdleScreen::waitEvent(window, event);
+        }
 
-            // Pause game with ESC
-            if (gameState == GameState::PLAYING && event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
-                gameState = GameState::PAUSED;
-            }
+        allocationCheck.beginFrame();
+        frameArena.reset();
+        profiler.beginFrame();
+        const RenderSnapshot& snapshot = sim.latest();
+
+        {
+            ProfileScope scope(profiler, ProfilePhase::Events);
+            while (waited || window.pollEvent(event)) {
+                waited = false;
+                if (event.type == sf::Event::Closed)
+                    window.close();
+
+                if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F3) {
+                    showProfiler = !showProfiler;
+                }
+                if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F4) {
+                    pacer.setMode(PacingMode((std::size_t(pacer.mode()) + 1) % PACING_MODE_COUNT));
+                    applyPacing();
+                }
+
+                // Jump input goes to the simulation thread stamped with when it was seen,
+                // so it lands on the tick it happened in
+                if ((event.type == sf::Event::KeyPressed || event.type == sf::Event::KeyReleased) &&
+                    event.key.code == sf::Keyboard::Space) {
+                    sim.pushInput({event.type == sf::Event::KeyPressed ? InputAction::JumpPressed : InputAction::JumpReleased,
+                                   std::chrono::steady_clock::now()});
+                }
+                if (event.type == sf::Event::LostFocus) {
+                    sim.pushInput({InputAction::JumpReleased, std::chrono::steady_clock::now()}); // the key-up would go to another window
+                }
+
+                // Pause game with ESC
+                if (gameState == GameState::PLAYING && event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
+                    gameState = GameState::PAUSED;
+                }
 
-            // Pause menu button handling
-            if (gameState == GameState::PAUSED) {
-                if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
-                    sf::Vector2i mousePos = sf::Mouse::getPosition(window);
-                    if (resumeButton.getGlobalBounds().contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y))) {
-                        gameState = GameState::PLAYING;
-                    } else if (restartButton.getGlobalBounds().contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y))) {
-                        // Reset game state
-                        gameOver = false;
-                        lives = MAX_LIVES;
-                        coinCount = 0;
-                        gameClock.restart();
-                        gameSpeed = 1.0f;
-                        playerSprite.setPosition(100, GROUND_Y - FRAME_HEIGHT);
-                        playerVelocityY = 0;
-                        isJumping = false;
-                        gameEndTime = 0.0f;
-                        for (auto& coin : coins) coin.collected = false;
-                        // Reset platforms, coins, obstacles as in your restart logic
-                        platforms[0].sprite.setPosition(200, 400);
-                        platforms[1].sprite.setPosition(500, 300);
-                        platforms[2].sprite.setPosition(800, 200);
-                        platforms[3].sprite.setPosition(1200, 350);
-                        platforms[4].sprite.setPosition(1600, 250);
-                        coins[0].sprite.setPosition(platforms[0].x + 20, platforms[0].y - COIN_SIZE - 15);
-                        coins[1].sprite.setPosition(platforms[1].x + 130, platforms[1].y - COIN_SIZE - 15);
-                        coins[2].sprite.setPosition(platforms[2].x + 20, platforms[2].y - COIN_SIZE - 15);
-                        coins[3].sprite.setPosition(platforms[3].x + 130, platforms[3].y - COIN_SIZE - 15);
-                        coins[4].sprite.setPosition(650, GROUND_Y - COIN_SIZE - 15);
-                        obstacles[0].sprite.setPosition(WINDOW_WIDTH + 300, platforms[0].y - OBSTACLE_SIZE);
-                        obstacles[0].visible = true;
-                        obstacles[1].sprite.setPosition(WINDOW_WIDTH + 600, GROUND_Y - OBSTACLE_SIZE);
-                        obstacles[1].visible = true;
-                        obstacles[2].sprite.setPosition(WINDOW_WIDTH + 900, platforms[2].y - OBSTACLE_SIZE);
-                        obstacles[2].visible = true;
-                        obstacles[3].sprite.setPosition(WINDOW_WIDTH + 1200, GROUND_Y - OBSTACLE_SIZE);
-                        obstacles[3].visible = true;
-                        gameState = GameState::PLAYING;
-                    } else if (mainMenuButton.getGlobalBounds().contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y))) {
-                        gameState = GameState::MENU; // Always go to MENU, not HIGH_SCORE
+                // Pause menu button handling
+                if (gameState == GameState::PAUSED) {
+                    if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
+                        sf::Vector2i mousePos = sf::Mouse::getPosition(window);
+                        if (resumeButton.getGlobalBounds().contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y))) {
+                            gameState = GameState::PLAYING;
+                        } else if (restartButton.getGlobalBounds().contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y))) {
+                            startNewRun();
+                            gameState = GameState::PLAYING;
+                        } else if (mainMenuButton.getGlobalBounds().contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y))) {
+                            gameState = GameState::MENU; // Always go to MENU, not HIGH_SCORE
+                        }
                     }
                 }
-            }
-            // In MENU state
-            if (gameState == GameState::MENU) {
-                if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
-                    sf::Vector2i mousePos = sf::Mouse::getPosition(window);
-                    if (startButton.getGlobalBounds().contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y))) {
-                        gameState = GameState::PLAYING;
-                        // Reset game state if needed
-                        gameOver = false;
-                        lives = MAX_LIVES;
-                        coinCount = 0;
-                        gameClock.restart();
-                        gameSpeed = 1.0f;
-                        playerSprite.setPosition(100, GROUND_Y - FRAME_HEIGHT);
-                        playerVelocityY = 0;
-                        isJumping = false;
-                        gameEndTime = 0.0f;
-                        for (auto& coin : coins) coin.collected = false;
-                        // Start BGM2 when game starts
-                        if (bgm2Loaded) bgm2.play();
-                    } else if (highScoreButton.getGlobalBounds().contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y))) {
-                        gameState = GameState::HIGH_SCORE;
+                // In MENU state
+                if (gameState == GameState::MENU) {
+                    if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
+                        sf::Vector2i mousePos = sf::Mouse::getPosition(window);
+                        if (startButton.getGlobalBounds().contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y))) {
+                            gameState = GameState::PLAYING;
+                            startNewRun();
+                            // Start BGM2 when game starts
+                            if (bgm2Loaded) bgm2.play();
+                        } else if (highScoreButton.getGlobalBounds().contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y))) {
+                            gameState = GameState::HIGH_SCORE;
+                        }
                     }
                 }
-            }
-            // In HIGH_SCORE state
-            if (gameState == GameState::HIGH_SCORE) {
-                if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
-                    sf::Vector2i mousePos = sf::Mouse::getPosition(window);
-                    if (backButton.getGlobalBounds().contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y))) {
+                // In HIGH_SCORE state
+                if (gameState == GameState::HIGH_SCORE) {
+                    if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
+                        sf::Vector2i mousePos = sf::Mouse::getPosition(window);
+                        if (backButton.getGlobalBounds().contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y))) {
+                            gameState = GameState::MENU;
+                        }
+                    }
+                    // (Keep ESC key handling if you want)
+                    if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
                         gameState = GameState::MENU;
                     }
                 }
-                // (Keep ESC key handling if you want)
-                if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
-                    gameState = GameState::MENU;
-                }
-            }
-            // ...existing event handling for PLAYING state...
-            if (gameState == GameState::PLAYING) {
-                // (keep your existing event handling for restart/gameplay here)
-                if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::R && gameOver) {
-                    // Reset game state
-                    gameOver = false;
-                    lives = MAX_LIVES;
-                    coinCount = 0;
-                    gameClock.restart();
-                    gameSpeed = 1.0f; // Reset speed multiplier
-                    playerSprite.setPosition(100, GROUND_Y - FRAME_HEIGHT);
-                    playerVelocityY = 0;
-                    isJumping = false;
-                    // Reset game end time
-                    gameEndTime = 0.0f; // This will now work
-                    // Reset all coins
-                    for (auto& coin : coins) {
-                        coin.collected = false;
+                // ...existing event handling for PLAYING state...
+                if (gameState == GameState::PLAYING) {
+                    // (keep your existing event handling for restart/gameplay here)
+                    // Practice: rewind a couple of seconds (even out of a game over), or restart the level
+                    if (practice && event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Backspace) {
+                        sim.rewind();
                     }
-                    // Reset platform positions
-                    platforms[0].sprite.setPosition(200, 400);
-                    platforms[1].sprite.setPosition(500, 300);
-                    platforms[2].sprite.setPosition(800, 200);
-                    platforms[3].sprite.setPosition(1200, 350);
-                    platforms[4].sprite.setPosition(1600, 250);
-                    // Reset coin positions (different from obstacles)
-                    coins[0].sprite.setPosition(platforms[0].x + 20, platforms[0].y - COIN_SIZE - 15);
-                    coins[1].sprite.setPosition(platforms[1].x + 130, platforms[1].y - COIN_SIZE - 15);
-                    coins[2].sprite.setPosition(platforms[2].x + 20, platforms[2].y - COIN_SIZE - 15);
-                    coins[3].sprite.setPosition(platforms[3].x + 130, platforms[3].y - COIN_SIZE - 15);
-                    coins[4].sprite.setPosition(650, GROUND_Y - COIN_SIZE - 15);
-                    // Reset obstacle positions and visibility (starting off-screen)
-                    obstacles[0].sprite.setPosition(WINDOW_WIDTH + 300, platforms[0].y - OBSTACLE_SIZE);
-                    obstacles[0].visible = true;
-                    obstacles[1].sprite.setPosition(WINDOW_WIDTH + 600, GROUND_Y - OBSTACLE_SIZE); // obstacle2 on ground only
-                    obstacles[1].visible = true;
-                    obstacles[2].sprite.setPosition(WINDOW_WIDTH + 900, platforms[2].y - OBSTACLE_SIZE);
-                    obstacles[2].visible = true;
-                    obstacles[3].sprite.setPosition(WINDOW_WIDTH + 1200, GROUND_Y - OBSTACLE_SIZE); // obstacle2 on ground only
-                    obstacles[3].visible = true;
-                    // --- FIX: Restart BGM2 on restart ---
-                    if (bgm2Loaded) {
-                        bgm2.stop(); // Ensure it is stopped first
-                        bgm2.play(); // Start again
+                    if (practice && event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Enter) {
+                        sim.retry();
+                    }
+                    if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::R && snapshot.gameOver) {
+                        startNewRun();
+                        // --- FIX: Restart BGM2 on restart ---
+                        if (bgm2Loaded) {
+                            bgm2.stop(); // Ensure it is stopped first
+                            bgm2.play(); // Start again
+                        }
                     }
                 }
             }
         }
 
+        // Screen changes, new runs, game overs and showing the overlay may allocate, so the
+        // check starts over after them
+        if (gameState != settledState || snapshot.runs != settledRuns || snapshot.gameOvers != settledGameOvers ||
+            showProfiler != settledShowProfiler) {
+            allocationCheck.unsteady();
+            settledState = gameState;
+            settledRuns = snapshot.runs;
+            settledGameOvers = snapshot.gameOvers;
+            settledShowProfiler = showProfiler;
+        }
+
+        // The simulation only ticks while a run is on screen
+        sim.setPaused(gameState != GameState::PLAYING);
+
         window.clear(sf::Color(100, 149, 237)); // sky blue
 
+        // What an idle screen shows: which one, and the scores on it
+        const std::uint64_t idleKey = std::uint64_t(gameState) | std::uint64_t(leaderboard.runCount()) << 8;
+
         if (gameState == GameState::MENU) {
-            window.draw(backgroundSprite);
-            if (logoLoaded) window.draw(logoSprite);
-            window.draw(titleText);
-            window.draw(startButton);
-            window.draw(startText);
-            window.draw(highScoreButton);
-            window.draw(highScoreText);
-            window.display();
+            if (sf::RenderTarget* canvas = idleScreen.compose(idleKey, sf::Color(100, 149, 237))) {
+                canvas->draw(backgroundSprite);
+                if (logoLoaded) canvas->draw(logoSprite);
+                canvas->draw(titleText);
+                canvas->draw(startButton);
+                canvas->draw(startText);
+                canvas->draw(highScoreButton);
+                canvas->draw(highScoreText);
+            }
+            idleScreen.draw(window);
+            presentIdle();
             continue;
         }
 
         if (gameState == GameState::PAUSED) {
-            window.draw(backgroundSprite);
-            window.draw(resumeButton);
-            window.draw(resumeText);
-            window.draw(restartButton);
-            window.draw(restartMenuText);
-            window.draw(mainMenuButton);
-            window.draw(mainMenuText);
-            window.display();
-            continue;
-        }
-
-        if (gameState == GameState::HIGH_SCORE) {
-            window.draw(backgroundSprite);
-            sf::Text hsTitle("HIGH SCORES", font, 40);
-            hsTitle.setFillColor(sf::Color::Black);
-            hsTitle.setPosition(WINDOW_WIDTH / 2 - hsTitle.getLocalBounds().width / 2, 120);
-            window.draw(hsTitle);
-
-            for (size_t i = 0; i < highScores.size(); ++i) {
-                sf::Text scoreLine(std::to_string(i + 1) + ". " + std::to_string(highScores[i]), font, 32);
-                scoreLine.setFillColor(sf::Color::Black);
-                scoreLine.setPosition(WINDOW_WIDTH / 2 - 60, 200 + 50 * i);
-                window.draw(scoreLine);
+            if (sf::RenderTarget* canvas = idleScreen.compose(idleKey, sf::Color(100, 149, 237))) {
+                canvas->draw(backgroundSprite);
+                canvas->draw(resumeButton);
+                canvas->draw(resumeText);
+                canvas->draw(restartButton);
+                canvas->draw(restartMenuText);
+                canvas->draw(mainMenuButton);
+                canvas->draw(mainMenuText);
             }
-
-            sf::Text escHint("Press ESC to return", font, 24);
-            escHint.setFillColor(sf::Color::Black);
-            escHint.setPosition(WINDOW_WIDTH / 2 - 100, 400);
-            window.draw(escHint);
-
-            // --- Back button (top right corner) ---
-            window.draw(backButton);
-            window.draw(backText);
-            // --- End back button ---
-
-            window.display();
+            idleScreen.draw(window);
+            presentIdle();
             continue;
         }
 
-        if (!gameOver) {
-            // Calculate game speed based on time - gradual increase every 10 seconds
-            float elapsedTime = gameClock.getElapsedTime().asSeconds();
-            if (elapsedTime > 10.0f) {
-                // Gradual speed increase by 1.3x every 10 seconds
-                float speedMultiplier = 1.0f + (std::floor(elapsedTime / 10.0f) * 0.3f);
-                gameSpeed = std::min(speedMultiplier, 3.0f); // Cap at 3x speed
-            } else {
-                gameSpeed = 1.0f; // Normal speed for first 10 seconds
-            }
-
-            float currentSpeed = baseSpeed * gameSpeed;
-
-            // Move clouds to the left, loop them
-            for (auto& cloud : clouds) {
-                cloud.move(-currentSpeed, 0);
-                if (cloud.getPosition().x < -150) {
-                    cloud.setPosition(WINDOW_WIDTH + 50, cloud.getPosition().y);
-                }
-            }
-
-            // Move platforms to the left, loop them
-            for (auto& p : platforms) {
-                p.sprite.move(-currentSpeed, 0);
-                if (p.sprite.getPosition().x < -PLATFORM_WIDTH) {
-    float maxX = 0;
-    for (auto& pp : platforms) {
-        maxX = std::max(maxX, pp.sprite.getPosition().x);
-    }
-    float randY = yDist(gen);
-    p.y = randY;
-    p.sprite.setPosition(maxX + 300 + xDist(gen) / 2, randY); // Randomize both X gap and Y
-}
-            }
-
-            // Move obstacles to the left, loop them (only after 5 seconds)
-            elapsedTime = gameClock.getElapsedTime().asSeconds();
-            if (elapsedTime > 5.0f) { // Only move obstacles after 5 seconds
-                for (auto& obs : obstacles) {
-                    obs.sprite.move(-currentSpeed, 0);
-                    if (obs.sprite.getPosition().x < -OBSTACLE_SIZE) {
-                        // Finding the rightmost obstacle and place this one after it
-                        float maxX = 0;
-                        for (auto& oo : obstacles) {
-                            maxX = std::max(maxX, oo.sprite.getPosition().x);
-                        }
-                        
-                        // Set Y position based on obstacle type
-                        float newY;
-                        if (obs.type == 2) {
-                            newY = GROUND_Y - OBSTACLE_SIZE; // Type 2 obstacles only on ground
-                        } else {
-                            // Type 1 obstacles can be on platforms or ground
-                            int randomChoice = rand() % 6; // 0-5
-                            if (randomChoice < 5) {
-                                newY = platforms[randomChoice].y - OBSTACLE_SIZE; // On platform
-                            } else {
-                                newY = GROUND_Y - OBSTACLE_SIZE; // On ground
-                            }
-                        }
-                        
-                        obs.sprite.setPosition(maxX + 500, newY); // More spacing
-                        obs.visible = true; // Reset visibility when recycling
-                    }
-                }
-            }
-
-            // Move coins to the left, loop them (ensure they keep coming)
-            for (auto& coin : coins) {
-                coin.sprite.move(-currentSpeed, 0);
-                if (coin.sprite.getPosition().x < -COIN_SIZE) {
-                    // Find the rightmost coin and place this one after it
-                    float maxX = 0;
-                    for (auto& cc : coins) {
-                        maxX = std::max(maxX, cc.sprite.getPosition().x);
-                    }
-                    coin.sprite.setPosition(maxX + 350, coin.sprite.getPosition().y);
-                    coin.collected = false; // Reset collected status when recycling
-                }
-            }
-
-            //Jump - reduced jump height
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::Space) && !isJumping) {
-                playerVelocityY = -10; // *** JUMP HEIGHT VALUE *** - Changed from -10 to -12 for higher jump
-                isJumping = true;
-            }
-
-            //Gravity
-            playerVelocityY += GRAVITY;
-            playerSprite.move(0, playerVelocityY);
-
-            //Landing on ground or platforms
-            bool onPlatform = false;
-            for (auto& p : platforms) {
-                sf::FloatRect platBounds = p.sprite.getGlobalBounds();
-                sf::FloatRect playerBounds = playerSprite.getGlobalBounds();
-                if (playerBounds.intersects(platBounds) &&
-                    playerVelocityY >= 0 &&
-                    playerBounds.top + playerBounds.height - 10 < platBounds.top + 10) {
-                    playerSprite.setPosition(playerSprite.getPosition().x, platBounds.top - playerBounds.height);
-                    playerVelocityY = 0;
-                    isJumping = false;
-                    onPlatform = true;
+        if (gameState == GameState::HIGH_SCORE) {
+            if (shownRunCount != leaderboard.runCount()) {
+                std::vector<RunRecord> best = leaderboard.top(3);
+                best.resize(3); // Always show three lines, zeros until there are enough runs
+                scoreLines.clear();
+                for (size_t i = 0; i < best.size(); ++i) {
+                    int score = static_cast<int>(best[i].time);
+                    sf::Text scoreLine(std::to_string(i + 1) + ". " + std::to_string(score), font, 32);
+                    scoreLine.setFillColor(sf::Color::Black);
+                    scoreLine.setPosition(WINDOW_WIDTH / 2 - 60, 200 + 50 * i);
+                    scoreLines.push_back(scoreLine);
                 }
+                shownRunCount = leaderboard.runCount();
             }
-            // Ground landing
-            if (playerSprite.getPosition().y >= GROUND_Y - playerSprite.getGlobalBounds().height) {
-                playerSprite.setPosition(playerSprite.getPosition().x, GROUND_Y - playerSprite.getGlobalBounds().height);
-                playerVelocityY = 0;
-                isJumping = false;
-            }
+            if (sf::RenderTarget* canvas = idleScreen.compose(idleKey, sf::Color(100, 149, 237))) {
+                canvas->draw(backgroundSprite);
+                canvas->draw(hsTitle);
+                for (const sf::Text& scoreLine : scoreLines) canvas->draw(scoreLine);
 
-            // Animate player
-            animationTimer += (1.0f / 60.0f);
-            if (animationTimer >= FRAME_DURATION) {
-                animationTimer = 0.0f;
-                currentFrame = (currentFrame + 1) % FRAME_COUNT;
-                playerSprite.setTextureRect(sf::IntRect(currentFrame * FRAME_WIDTH, 0, FRAME_WIDTH, FRAME_HEIGHT));
-            }
+                canvas->draw(escHint);
 
-            // --- Coin collection ---
-            for (auto& coin : coins) {
-                if (!coin.collected && playerSprite.getGlobalBounds().intersects(coin.sprite.getGlobalBounds())) {
-                    coin.collected = true;
-                    coinCount++;
-                    coinSound.play(); // Play sound when coin is collected
-                }
+                // --- Back button (top right corner) ---
+                canvas->draw(backButton);
+                canvas->draw(backText);
+                // --- End back button ---
             }
-
-            // --- Obstacle collision (only after 5 seconds) ---
-            static sf::Clock collisionCooldown;
-            if (elapsedTime > 5.0f && collisionCooldown.getElapsedTime().asSeconds() > 0.7f) {
-                for (auto& obs : obstacles) {
-                    if (obs.visible && playerSprite.getGlobalBounds().intersects(obs.sprite.getGlobalBounds())) {
-                        lives--;
-                        collisionCooldown.restart();
-                        obsSound.play();
-                        obs.visible = false;
-                        if (lives <= 0) {
-                            if (!gameOver) {
-                                gameOver = true;
-                                gameOverSoundPlayed = false; // Reset flag on new game over
-                            }
-                            if (!gameOverSoundPlayed) {
-                                gameOverSound.play();
-                                gameOverSoundPlayed = true;
-                            }
-                        }
-                        break;
-                    }
+            idleScreen.draw(window);
+            presentIdle();
+            continue;
+        }
+        idleShown = false;
+
+        {
+            ProfileScope scope(profiler, ProfilePhase::Update);
+
+            // Play what happened since the last frame, one coin sound per coin even when
+            // several were collected in one tick or frame
+            std::uint64_t newPickups = std::min<std::uint64_t>(snapshot.coinPickups - seenCoinPickups,
+                                                               std::uint64_t(coinSettings.voices));
+            for (std::uint64_t i = 0; i < newPickups; ++i) sfx.play(coinSound);
+            if (snapshot.obstacleHits != seenObstacleHits) sfx.play(obsSound);
+            if (snapshot.gameOvers != seenGameOvers) {
+                sfx.play(gameOverSound);
+                if (!snapshot.replaying && !snapshot.practice) {
+                    RunRecord run;
+                    run.time = snapshot.gameEndTime;
+                    run.coins = snapshot.coinCount;
+                    run.seed = snapshot.seed;
+                    run.date = std::int64_t(std::time(nullptr));
+                    leaderboard.add(run);
                 }
             }
+            seenCoinPickups = snapshot.coinPickups;
+            seenObstacleHits = snapshot.obstacleHits;
+            seenGameOvers = snapshot.gameOvers;
         }
-
-        //Draw everything
-        window.clear(sf::Color(100, 149, 237)); // sky blue
-
-        // --- Draw background first ---
-        window.draw(backgroundSprite);
-
-        // Draw clouds
-        for (auto& cloud : clouds) window.draw(cloud);
-
-        // Draw platforms
-        for (auto& p : platforms) window.draw(p.sprite);
-
-        // Draw coins
-        for (auto& coin : coins) if (!coin.collected) window.draw(coin.sprite);
-
-        // Draw obstacles
-        for (auto& obs : obstacles) {
-            if (obs.visible) {
-                window.draw(obs.sprite);
+        const float alpha = snapshot.alpha(std::chrono::steady_clock::now());
+
+        {
+            ProfileScope scope(profiler, ProfilePhase::Draw);
+            //Draw everything
+            scene.draw(window, snapshot, alpha);
+
+            if (snapshot.gameOver) {
+                // Stop BGM2 when game is over
+                if (bgm2Loaded && bgm2.getStatus() == sf::Music::Playing) bgm2.stop();
+            } else if (snapshot.practice && bgm2Loaded && bgm2.getStatus() != sf::Music::Playing) {
+                bgm2.play(); // rewound or retried out of a game over
             }
-        }
 
-        window.draw(groundSprite); // Changed from window.draw(ground);
-        window.draw(playerSprite);
-
-        // Draw lives
-        for (int i = 0; i < lives; ++i) window.draw(lifeIcons[i]);
-
-        // Draw score and coin count
-        std::stringstream ss;
-        
-        if (!gameOver) {
-            gameEndTime = gameClock.getElapsedTime().asSeconds(); // Update while game is running
-            ss << "Time: " << static_cast<int>(gameEndTime);
-        } else {
-            ss << "Time: " << static_cast<int>(gameEndTime); // Show final time when game over
-        }
-        scoreText.setString(ss.str());
-        scoreText.setPosition(10, 50);
-        window.draw(scoreText);
-
-        coinText.setString("Coins: " + std::to_string(coinCount));
-        coinText.setPosition(10, 80);
-        window.draw(coinText);
-
-        if (gameOver) {
-            window.draw(gameOverText);
-            window.draw(restartText);
-            // Stop BGM2 when game is over
-            if (bgm2Loaded && bgm2.getStatus() == sf::Music::Playing) bgm2.stop();
+            if (showProfiler) profilerOverlay.draw(window, profiler, pacer, allocationCheck, frameArena);
         }
 
-        // After detecting game over and before drawing the high score screen, add this block:
-        if (gameOver) {
-            // Only update high scores once per game over
-            static bool highScoreUpdated = false;
-            if (!highScoreUpdated) {
-                // Add the new score and keep top 3
-                highScores.push_back(static_cast<int>(gameEndTime));
-                std::sort(highScores.rbegin(), highScores.rend());
-                if (highScores.size() > 3) highScores.resize(3);
-                highScoreUpdated = true;
-            }
-            // Reset flag when restarting or going to menu
-            if (gameState == GameState::MENU || (sf::Keyboard::isKeyPressed(sf::Keyboard::R) && gameOver)) {
-                highScoreUpdated = false;
+        {
+            ProfileScope scope(profiler, ProfilePhase::Display);
+            present();
+        }
+        // First frame that shows a new jump: measure from its key press to now
+        if (snapshot.pressedJumps != seenPressedJumps) {
+            if (!snapshot.replaying) {
+                std::chrono::duration<float, std::milli> latency = std::chrono::steady_clock::now() - snapshot.jumpPressTime;
+                profiler.addInputLatency(latency.count());
             }
+            seenPressedJumps = snapshot.pressedJumps;
         }
+    }
 
-        window.display();
+    // Frame interval summary for every mode that was used, to compare them on this monitor
+    std::cout << "Frame pacing, ms between presents:" << std::endl;
+    for (std::size_t i = 0; i < PACING_MODE_COUNT; ++i) {
+        const IntervalStats& stats = pacer.stats(PacingMode(i));
+        if (stats.count == 0) continue;
+        std::cout << "  " << pacingModeName(PacingMode(i)) << ": mean " << stats.mean << ", stddev "
+                  << stats.stddev() << ", max " << stats.max << " over " << stats.count << " frames" << std::endl;
     }
 
+    if (allocationCheck.reporting()) {
+        std::cout << "Steady-state frames that allocated: " << allocationCheck.flaggedFrames() << std::endl;
+        if (allocationCheck.flaggedFrames() > 0) return 3;
+    }
     return 0;
 }
 
@@ -0,0 +1,24 @@
+#include "parallax.hpp"
+
+#include <cmath>
+
+#include "config.hpp"
+
+sf::FloatRect ParallaxLayer::textureRect(double distance) const {
+    // Texture pixels per screen pixel
+    const float scale = float(textureSize.y) / height;
+    // Wrap in double first, so the offset stays exact however long the run goes on
+    const double tileWidth = double(textureSize.x) / scale;
+    const float offset = float(std::fmod(distance * speedFactor, tileWidth));
+    return sf::FloatRect(offset * scale, 0.0f, WINDOW_WIDTH * scale, float(textureSize.y));
+}
+
+sf::Image makeCloudStrip(const sf::Image& cloud, unsigned int width, unsigned int height,
+                         const sf::Vector2u* positions, std::size_t count) {
+    sf::Image strip;
+    strip.create(width, height, sf::Color::Transparent);
+    for (std::size_t i = 0; i < count; ++i) {
+        strip.copy(cloud, positions[i].x, positions[i].y);
+    }
+    return strip;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+
+// Scrolling background layers.
+//
+// Each layer is one window-wide quad over a repeated texture (setRepeated(true)).
+// Scrolling only moves the quad's texture coordinates, so a layer costs the same
+// single quad however far the world has moved, and nothing has to be recycled.
+// speedFactor is how fast the layer moves relative to the world: 1 moves with the
+// platforms, smaller values are further away.
+struct ParallaxLayer {
+    std::size_t batchLayer; // SpriteBatch layer holding the repeated texture
+    sf::Vector2u textureSize;
+    float y, height;        // on screen; the texture is scaled to this height, keeping its aspect
+    float speedFactor;
+
+    // The part of the texture to show across the window once the world has scrolled by distance
+    sf::FloatRect textureRect(double distance) const;
+};
+
+// A strip of clouds to tile as a layer: copies of cloud, left to right at the given
+// positions (top left, in pixels) on a transparent width x height image
+sf::Image makeCloudStrip(const sf::Image& cloud, unsigned int width, unsigned int height,
+                         const sf::Vector2u* positions, std::size_t count);
@@ -0,0 +1,97 @@
+#include "profiler_overlay.hpp"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+
+#include "config.hpp"
+#include "hud.hpp"
+
+namespace {
+
+const float PANEL_WIDTH = 340.0f;
+const float PANEL_HEIGHT = 250.0f;
+const float GRAPH_HEIGHT = 70.0f;
+const float GRAPH_MAX_MS = 50.0f;   // taller frames are clipped at the top
+const float FRAME_BUDGET_MS = 1000.0f / 60.0f;
+const std::size_t TEXT_CAPACITY = 1024;
+
+// snprintf onto the end of text, which holds length characters
+void appendLine(char* text, std::size_t& length, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int written = std::vsnprintf(text + length, TEXT_CAPACITY - length, fmt, args);
+    va_end(args);
+    if (written > 0) length = std::min(TEXT_CAPACITY - 1, length + std::size_t(written));
+}
+
+} // namespace
+
+ProfilerOverlay::ProfilerOverlay(const sf::Font& font)
+    : panel(sf::Vector2f(PANEL_WIDTH, PANEL_HEIGHT)),
+      graph(sf::Quads),
+      budgetLine(sf::Lines, 2) {
+    panel.setFillColor(sf::Color(0, 0, 0, 170));
+    panel.setPosition(WINDOW_WIDTH - PANEL_WIDTH - 10, 10);
+    text.setFont(font);
+    text.setCharacterSize(14);
+    text.setFillColor(sf::Color::White);
+    text.setPosition(WINDOW_WIDTH - PANEL_WIDTH, 14);
+    prewarmGlyphs(text, "0123456789. msnowavgp9xeturdiplyfacF4,kbh");
+
+    const float graphBottom = 10 + PANEL_HEIGHT - 8;
+    const float budgetY = graphBottom - GRAPH_HEIGHT * FRAME_BUDGET_MS / GRAPH_MAX_MS;
+    budgetLine[0] = sf::Vertex(sf::Vector2f(WINDOW_WIDTH - PANEL_WIDTH - 2, budgetY), sf::Color(255, 80, 80));
+    budgetLine[1] = sf::Vertex(sf::Vector2f(WINDOW_WIDTH - 18, budgetY), sf::Color(255, 80, 80));
+}
+
+void ProfilerOverlay::draw(sf::RenderTarget& target, const FrameProfiler& profiler, const FramePacer& pacer,
+                           const FrameAllocationCheck& allocations, FrameArena& arena) {
+    char* lines = arena.allocateArray<char>(TEXT_CAPACITY);
+    std::size_t length = 0;
+    appendLine(lines, length, "%-8s %6s %6s %6s %6s\n", "ms", "now", "avg", "p99", "max");
+    for (std::size_t row = 0; row <= FrameProfiler::FRAME_TOTAL; ++row) {
+        FrameProfiler::Stats s = profiler.stats(row);
+        appendLine(lines, length, "%-8s %6.2f %6.2f %6.2f %6.2f\n",
+                   FrameProfiler::phaseName(row), s.current, s.average, s.p99, s.max);
+    }
+    // Key down to the display() that first showed the jump
+    FrameProfiler::Stats latency = profiler.inputLatency();
+    appendLine(lines, length, "%-8s %6.2f %6.2f %6.2f %6.2f\n", "input",
+               latency.current, latency.average, latency.p99, latency.max);
+    // Present-to-present interval in the current pacing mode (F4 switches)
+    const IntervalStats& pacing = pacer.stats(pacer.mode());
+    appendLine(lines, length, "%-8s avg %.2f sd %.2f max %.2f\n", pacingModeName(pacer.mode()),
+               pacing.mean, pacing.stddev(), pacing.max);
+    // Heap allocations on this thread last frame, and steady-state frames that had any
+    if (ALLOCATION_TRACKING) {
+        appendLine(lines, length, "%-8s %llu last frame, %llu flagged\n", "allocs",
+                   static_cast<unsigned long long>(allocations.lastFrameAllocations()),
+                   static_cast<unsigned long long>(allocations.flaggedFrames()));
+    } else {
+        appendLine(lines, length, "%-8s not counted in this build\n", "allocs");
+    }
+    assignAscii(string, lines, length);
+    text.setString(string);
+
+    // Frame time graph, newest on the right
+    const float graphBottom = 10 + PANEL_HEIGHT - 8;
+    const float graphLeft = WINDOW_WIDTH - PANEL_WIDTH - 2;
+    const float barWidth = (PANEL_WIDTH - 16) / FrameProfiler::HISTORY;
+    graph.clear();
+    for (std::size_t i = 0; i < profiler.frameCount(); ++i) {
+        float ms = profiler.frameTime(FrameProfiler::FRAME_TOTAL, i);
+        float height = GRAPH_HEIGHT * std::min(ms, GRAPH_MAX_MS) / GRAPH_MAX_MS;
+        float x = graphLeft + (FrameProfiler::HISTORY - profiler.frameCount() + i) * barWidth;
+        sf::Color color = ms > FRAME_BUDGET_MS * 1.5f ? sf::Color(255, 80, 80) : sf::Color(120, 220, 120);
+        graph.append(sf::Vertex(sf::Vector2f(x, graphBottom - height), color));
+        graph.append(sf::Vertex(sf::Vector2f(x + barWidth, graphBottom - height), color));
+        graph.append(sf::Vertex(sf::Vector2f(x + barWidth, graphBottom), color));
+        graph.append(sf::Vertex(sf::Vector2f(x, graphBottom), color));
+    }
+
+    target.draw(panel);
+    target.draw(text);
+    target.draw(graph);
+    target.draw(budgetLine);
+}
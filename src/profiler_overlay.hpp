@@ -0,0 +1,27 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include "alloc_tracker.hpp"
+#include "frame_arena.hpp"
+#include "frame_pacer.hpp"
+#include "frame_profiler.hpp"
+
+// Draws FrameProfiler stats in the top right corner: a line per phase with current,
+// average, p99 and max milliseconds, the frame interval stats of the current pacing
+// mode, heap allocations, and a graph of the recent frame times.
+// The text is formatted in the frame arena, so drawing it doesn't allocate.
+class ProfilerOverlay {
+public:
+    explicit ProfilerOverlay(const sf::Font& font);
+
+    void draw(sf::RenderTarget& target, const FrameProfiler& profiler, const FramePacer& pacer,
+              const FrameAllocationCheck& allocations, FrameArena& arena);
+
+private:
+    sf::RectangleShape panel;
+    sf::Text text;
+    sf::String string; // kept, so updating the text reuses its storage
+    sf::VertexArray graph;      // one bar per frame
+    sf::VertexArray budgetLine; // 16.7 ms
+};
@@ -0,0 +1,154 @@
+#include "render_bench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "game_scene.hpp"
+#include "headless.hpp"
+#include "sim_thread.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Pixels where some channel differs by more than tolerance
+std::size_t countMismatches(const sf::Image& a, const sf::Image& b, int tolerance) {
+    const sf::Uint8* pa = a.getPixelsPtr();
+    const sf::Uint8* pb = b.getPixelsPtr();
+    const std::size_t pixels = std::size_t(a.getSize().x) * a.getSize().y;
+    std::size_t mismatches = 0;
+    for (std::size_t i = 0; i < pixels; ++i) {
+        for (int c = 0; c < 4; ++c) {
+            if (std::abs(int(pa[i * 4 + c]) - int(pb[i * 4 + c])) > tolerance) {
+                mismatches++;
+                break;
+            }
+        }
+    }
+    return mismatches;
+}
+
+std::string goldenPath(const std::string& directory, int frame, const char* suffix = "") {
+    return directory + "/frame_" + std::to_string(frame) + suffix + ".png";
+}
+
+// Compares (or, when updating, saves) one frame. Returns false if it doesn't match.
+bool checkFrame(const sf::Image& frame, int index, const RenderBenchOptions& options) {
+    const std::string path = goldenPath(options.goldenDirectory, index);
+    if (options.updateGolden) {
+        if (!frame.saveToFile(path)) throw std::runtime_error("Failed to write " + path);
+        std::cout << "  frame " << index << ": written to " << path << "\n";
+        return true;
+    }
+
+    sf::Image golden;
+    if (!golden.loadFromFile(path)) {
+        std::cout << "  frame " << index << ": no golden image " << path << " (run with --update-golden)\n";
+        return false;
+    }
+    if (golden.getSize() != frame.getSize()) {
+        std::cout << "  frame " << index << ": golden image is " << golden.getSize().x << "x" << golden.getSize().y
+                  << ", rendered " << frame.getSize().x << "x" << frame.getSize().y << "\n";
+        return false;
+    }
+    const std::size_t mismatches = countMismatches(frame, golden, options.tolerance);
+    const double fraction = double(mismatches) / (double(frame.getSize().x) * frame.getSize().y);
+    const bool ok = fraction <= options.maxMismatch;
+    std::cout << "  frame " << index << ": " << (ok ? "ok" : "DIFFERS") << ", " << mismatches
+              << " pixels past tolerance " << options.tolerance << "\n";
+    if (!ok) {
+        const std::string actualPath = goldenPath(options.goldenDirectory, index, ".actual");
+        if (frame.saveToFile(actualPath)) std::cout << "    rendered frame saved to " << actualPath << "\n";
+    }
+    return ok;
+}
+
+} // namespace
+
+std::vector<int> parseFrameList(const std::string& text) {
+    std::vector<int> frames;
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        std::size_t used = 0;
+        int frame = -1;
+        try {
+            frame = std::stoi(item, &used);
+        } catch (const std::exception&) {
+        }
+        if (frame < 0 || used != item.size()) throw std::runtime_error("Bad frame number \"" + item + "\"");
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+int runRenderBench(const LoadedAssets& assets, SimConfig config, const RenderBenchOptions& options) {
+    sf::RenderTexture target;
+    if (!target.create(WINDOW_WIDTH, WINDOW_HEIGHT)) {
+        throw std::runtime_error("Failed to create the offscreen render texture");
+    }
+    GameScene scene(assets);
+    scene.applySizes(config);
+
+    World world;
+    world.config = config;
+    resetWorld(world, options.seed);
+    RenderSnapshot snapshot;
+    int runs = 0;
+
+    const bool checking = !options.goldenDirectory.empty();
+    bool allMatch = true;
+    long drawCalls = 0;
+    int maxDrawCalls = 0;
+    Clock::duration renderTime{};
+
+    std::cout << "Rendering " << options.frames << " frames offscreen (" << WINDOW_WIDTH << "x" << WINDOW_HEIGHT
+              << ", seed " << options.seed << ")\n";
+    for (int frame : options.checkFrames) {
+        if (checking && frame >= options.frames) {
+            std::cout << "  frame " << frame << ": past the last frame rendered\n";
+            allMatch = false;
+        }
+    }
+    for (int frame = 0; frame < options.frames; ++frame) {
+        step(world, botInput(world));
+        if (world.gameOver) {
+            runs++;
+            resetWorld(world, options.seed + runs);
+        }
+        copyWorld(world, snapshot);
+
+        auto start = Clock::now();
+        scene.draw(target, snapshot, options.alpha);
+        target.display();
+        renderTime += Clock::now() - start;
+        drawCalls += scene.drawCalls();
+        maxDrawCalls = std::max(maxDrawCalls, scene.drawCalls());
+
+        // Reading a frame back waits for the GPU, so it stays outside the timed part
+        if (checking && std::find(options.checkFrames.begin(), options.checkFrames.end(), frame) !=
+                            options.checkFrames.end()) {
+            allMatch = checkFrame(target.getTexture().copyToImage(), frame, options) && allMatch;
+        }
+    }
+    // Wait for whatever the driver still has queued, so it counts too
+    auto start = Clock::now();
+    target.getTexture().copyToImage();
+    renderTime += Clock::now() - start;
+
+    const double seconds = std::chrono::duration<double>(renderTime).count();
+    std::cout << "Rendered " << options.frames << " frames in " << seconds << " s: "
+              << (seconds > 0 ? options.frames / seconds : 0) << " frames/s, "
+              << (options.frames > 0 ? seconds * 1000.0 / options.frames : 0) << " ms per frame\n";
+    std::cout << "Draw calls per frame: mean " << (options.frames > 0 ? double(drawCalls) / options.frames : 0)
+              << ", max " << maxDrawCalls << "\n";
+    if (checking && !options.updateGolden) {
+        std::cout << (allMatch ? "All checked frames match the golden images" : "Some frames differ from the golden images")
+                  << std::endl;
+    }
+    return allMatch ? 0 : 1;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "asset_loader.hpp"
+#include "simulation.hpp"
+
+// Offscreen render benchmark and golden-image check.
+//
+// Plays a bot run (botInput, fixed seed) and draws one frame per tick through GameScene
+// into an sf::RenderTexture, so no window is shown; it runs on a headless build server
+// with software GL (Mesa llvmpipe under Xvfb). Prints frames per second and draw calls
+// per frame, and compares the chosen frames with golden PNGs: a change to the renderer
+// should be faster here and still match them.
+struct RenderBenchOptions {
+    unsigned int seed = 1;
+    int frames = 1200;
+    float alpha = 0.5f; // frames are drawn halfway between ticks, so interpolation is covered
+    std::vector<int> checkFrames{60, 300, 600, 1100};
+    std::string goldenDirectory; // empty: timings only
+    bool updateGolden = false;   // write the checked frames as the new golden images
+    int tolerance = 8;           // per channel, out of 255
+    double maxMismatch = 0.001;  // fraction of pixels allowed past tolerance
+};
+
+// "60,300,600" -> frame numbers; throws std::runtime_error on anything else
+std::vector<int> parseFrameList(const std::string& text);
+
+// Returns 0 if every checked frame matches its golden image (or they were written),
+// 1 if any differ or are missing. config's sprite sizes are filled in from the assets.
+int runRenderBench(const LoadedAssets& assets, SimConfig config, const RenderBenchOptions& options);
@@ -0,0 +1,220 @@
+#include "replay.hpp"
+
+#include <cmath>
+#include <cstring> //For memcpy
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace {
+
+// Longest run a replay may hold, in simulated time. With the tick rate capped at
+// MAX_TICK_RATE this bounds what a damaged file can make loadReplay() allocate.
+const double MAX_REPLAY_SECONDS = 24.0 * 60 * 60;
+
+template <typename T>
+void writeValue(std::string& out, const T& value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+template <typename T>
+T readValue(const char*& cursor, const char* end) {
+    if (std::size_t(end - cursor) < sizeof(T)) throw std::runtime_error("Replay file is truncated");
+    T value;
+    std::memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return value;
+}
+
+void writeVarint(std::string& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(char((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(char(value));
+}
+
+std::uint64_t readVarint(const char*& cursor, const char* end) {
+    std::uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        std::uint8_t byte = readValue<std::uint8_t>(cursor, end);
+        value |= std::uint64_t(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return value;
+    }
+    throw std::runtime_error("Replay file has a bad input run");
+}
+
+} // namespace
+
+void Replay::begin(unsigned int seed_, const SimConfig& config_) {
+    seed = seed_;
+    config = config_;
+    jumps.clear();
+    result = ReplayResult();
+}
+
+void Replay::finish(const World& world) {
+    result = resultOf(world);
+}
+
+SimInput Replay::input(std::size_t tick) const {
+    SimInput in;
+    if (tick < jumps.size()) {
+        in.jump = (jumps[tick] & REPLAY_JUMP_HELD) != 0;
+        in.jumpPressed = (jumps[tick] & REPLAY_JUMP_PRESSED) != 0;
+    }
+    return in;
+}
+
+void saveReplay(const std::string& path, const Replay& replay) {
+    std::string out;
+    out.append(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    writeValue(out, REPLAY_VERSION);
+    writeValue(out, std::uint32_t(replay.seed));
+    const SimConfig& c = replay.config;
+    writeValue(out, c.tickSeconds);
+    writeValue(out, c.platformWidth);
+    writeValue(out, c.platformHeight);
+    writeValue(out, c.coinWidth);
+    writeValue(out, c.coinHeight);
+    writeValue(out, std::int32_t(c.stressEntities));
+    writeValue(out, std::uint8_t(c.levelMode));
+    writeValue(out, c.difficulty.speedStepSeconds);
+    writeValue(out, c.difficulty.speedStep);
+    writeValue(out, c.difficulty.maxSpeed);
+    writeValue(out, c.difficulty.obstacleStartSeconds);
+    writeValue(out, c.difficulty.hitCooldownSeconds);
+    writeValue(out, replay.result.tickCount);
+    writeValue(out, replay.result.coinCount);
+    writeValue(out, replay.result.lives);
+    writeValue(out, replay.result.gameEndTime);
+
+    // Run-length encode the input: a held jump is usually a few ticks in a row
+    std::vector<std::uint64_t> runs;
+    std::uint8_t state = 0;
+    std::uint64_t length = 0;
+    for (std::uint8_t jump : replay.jumps) {
+        std::uint8_t held = jump & REPLAY_JUMP_HELD;
+        if (held != state) {
+            runs.push_back(length);
+            state = held;
+            length = 0;
+        }
+        length++;
+    }
+    runs.push_back(length);
+    writeValue(out, std::uint64_t(runs.size()));
+    for (std::uint64_t run : runs) writeVarint(out, run);
+
+    // Presses are rare next to ticks, so store where they are
+    std::vector<std::uint64_t> presses;
+    std::uint64_t lastPress = 0;
+    for (std::size_t tick = 0; tick < replay.jumps.size(); ++tick) {
+        if (replay.jumps[tick] & REPLAY_JUMP_PRESSED) {
+            presses.push_back(tick - lastPress);
+            lastPress = tick;
+        }
+    }
+    writeValue(out, std::uint64_t(presses.size()));
+    for (std::uint64_t press : presses) writeVarint(out, press);
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.write(out.data(), std::streamsize(out.size()))) {
+        throw std::runtime_error("Failed to write replay " + path);
+    }
+}
+
+Replay loadReplay(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("Failed to open replay " + path);
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const char* cursor = data.data();
+    const char* end = cursor + data.size();
+
+    if (data.size() < sizeof(REPLAY_MAGIC) || std::memcmp(cursor, REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0) {
+        throw std::runtime_error(path + " is not a replay file");
+    }
+    cursor += sizeof(REPLAY_MAGIC);
+    if (readValue<std::uint32_t>(cursor, end) != REPLAY_VERSION) {
+        throw std::runtime_error(path + " is from an unsupported replay version");
+    }
+
+    Replay replay;
+    replay.seed = readValue<std::uint32_t>(cursor, end);
+    SimConfig& c = replay.config;
+    c.tickSeconds = readValue<float>(cursor, end);
+    if (!std::isfinite(c.tickSeconds) || c.tickSeconds < 1.0f / MAX_TICK_RATE) {
+        throw std::runtime_error(path + " has a bad tick length");
+    }
+    c.platformWidth = readValue<float>(cursor, end);
+    c.platformHeight = readValue<float>(cursor, end);
+    c.coinWidth = readValue<float>(cursor, end);
+    c.coinHeight = readValue<float>(cursor, end);
+    c.stressEntities = readValue<std::int32_t>(cursor, end);
+    if (c.stressEntities < 0 || c.stressEntities > MAX_STRESS_ENTITIES) {
+        throw std::runtime_error(path + " has a bad stress entity count");
+    }
+    std::uint8_t levelMode = readValue<std::uint8_t>(cursor, end);
+    if (levelMode > std::uint8_t(LevelMode::Recycled)) throw std::runtime_error(path + " has an unknown level mode");
+    c.levelMode = LevelMode(levelMode);
+    c.difficulty.speedStepSeconds = readValue<float>(cursor, end);
+    c.difficulty.speedStep = readValue<float>(cursor, end);
+    c.difficulty.maxSpeed = readValue<float>(cursor, end);
+    c.difficulty.obstacleStartSeconds = readValue<float>(cursor, end);
+    c.difficulty.hitCooldownSeconds = readValue<float>(cursor, end);
+    replay.result.tickCount = readValue<std::uint64_t>(cursor, end);
+    if (double(replay.result.tickCount) * c.tickSeconds > MAX_REPLAY_SECONDS) {
+        throw std::runtime_error(path + " is too long");
+    }
+    replay.result.coinCount = readValue<std::int32_t>(cursor, end);
+    replay.result.lives = readValue<std::int32_t>(cursor, end);
+    replay.result.gameEndTime = readValue<float>(cursor, end);
+
+    // Every run takes at least a byte, and together they can't be longer than the run
+    // was, so nothing is expanded until the lengths add up
+    std::uint64_t runCount = readValue<std::uint64_t>(cursor, end);
+    if (runCount > std::uint64_t(end - cursor)) throw std::runtime_error("Replay file is truncated");
+    std::vector<std::uint64_t> runs(std::size_t(runCount), 0);
+    std::uint64_t totalTicks = 0;
+    for (std::uint64_t& length : runs) {
+        length = readVarint(cursor, end);
+        if (length > replay.result.tickCount - totalTicks) throw std::runtime_error(path + " has a bad input run");
+        totalTicks += length;
+    }
+    replay.jumps.reserve(std::size_t(totalTicks));
+    std::uint8_t state = 0;
+    for (std::uint64_t length : runs) {
+        replay.jumps.insert(replay.jumps.end(), std::size_t(length), state);
+        state ^= REPLAY_JUMP_HELD;
+    }
+
+    std::uint64_t pressCount = readValue<std::uint64_t>(cursor, end);
+    std::uint64_t tick = 0;
+    for (std::uint64_t i = 0; i < pressCount; ++i) {
+        tick += readVarint(cursor, end);
+        if (tick >= replay.jumps.size()) throw std::runtime_error(path + " has a bad jump press");
+        replay.jumps[std::size_t(tick)] |= REPLAY_JUMP_PRESSED;
+    }
+    return replay;
+}
+
+void startReplay(World& world, const Replay& replay) {
+    world.config = replay.config;
+    resetWorld(world, replay.seed);
+}
+
+ReplayResult resultOf(const World& world) {
+    ReplayResult result;
+    result.tickCount = std::uint64_t(world.tick);
+    result.coinCount = world.coinCount;
+    result.lives = world.lives;
+    result.gameEndTime = world.gameEndTime;
+    return result;
+}
+
+bool operator==(const ReplayResult& a, const ReplayResult& b) {
+    return a.tickCount == b.tickCount && a.coinCount == b.coinCount && a.lives == b.lives &&
+           a.gameEndTime == b.gameEndTime;
+}
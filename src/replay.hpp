@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "simulation.hpp"
+
+// Recorded runs. The simulation is deterministic for a given seed, config and
+// per-tick input, so that is all a replay stores; playing it back reproduces the
+// run exactly, down to the tick the player died on.
+//
+// File layout (little-endian, like assets.pak):
+//   "JDRP", u32 version, u32 seed,
+//   f32 tickSeconds, f32 platformWidth, f32 platformHeight, f32 coinWidth, f32 coinHeight,
+//   i32 stressEntities, u8 levelMode,
+//   f32 speedStepSeconds, f32 speedStep, f32 maxSpeed, f32 obstacleStartSeconds, f32 hitCooldownSeconds
+//   u64 tickCount, i32 coinCount, i32 lives, f32 gameEndTime   (how the run ended)
+//   u64 runCount, then runCount varints: lengths of alternating runs of ticks with
+//   jump released / held, starting with released (so the first may be 0)
+//   u64 pressCount, then pressCount varints: ticks with a jump press, each as the
+//   distance from the previous one (the first from tick 0)
+const char REPLAY_MAGIC[4] = {'J', 'D', 'R', 'P'};
+const std::uint32_t REPLAY_VERSION = 3; // 2: jump presses, for jump buffering; 3: difficulty
+
+// Per-tick input bits in Replay::jumps
+const std::uint8_t REPLAY_JUMP_HELD = 1;
+const std::uint8_t REPLAY_JUMP_PRESSED = 2;
+
+struct ReplayResult {
+    std::uint64_t tickCount = 0;
+    std::int32_t coinCount = 0;
+    std::int32_t lives = 0;
+    float gameEndTime = 0.0f;
+};
+
+struct Replay {
+    unsigned int seed = 0;
+    SimConfig config;
+    std::vector<std::uint8_t> jumps; // one per tick, REPLAY_JUMP_* bits
+    ReplayResult result;             // recorded outcome, to check playback against
+
+    // Starts recording a new run
+    void begin(unsigned int seed, const SimConfig& config);
+    void record(const SimInput& input) {
+        jumps.push_back(std::uint8_t((input.jump ? REPLAY_JUMP_HELD : 0) | (input.jumpPressed ? REPLAY_JUMP_PRESSED : 0)));
+    }
+    // Stores how the run ended
+    void finish(const World& world);
+
+    SimInput input(std::size_t tick) const;
+};
+
+// Both throw std::runtime_error on failure. loadReplay() also refuses a header with settings
+// the simulation can't run (tick length, level mode, stress count), a run over a day long, or
+// more input than ticks.
+void saveReplay(const std::string& path, const Replay& replay);
+Replay loadReplay(const std::string& path);
+
+// Puts world at the start of the replayed run
+void startReplay(World& world, const Replay& replay);
+ReplayResult resultOf(const World& world);
+bool operator==(const ReplayResult& a, const ReplayResult& b);
@@ -0,0 +1,246 @@
+#include "sim_thread.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Clamp so a long stall doesn't cause a burst of catch-up ticks
+const float MAX_FRAME_SECONDS = 0.25f;
+
+// Practice history slots: REWIND_HISTORY_SECONDS of ticks, if they fit in REWIND_HISTORY_BYTES
+std::size_t rewindSlots(const SimConfig& config) {
+    std::size_t slots = std::size_t(std::ceil(REWIND_HISTORY_SECONDS / config.tickSeconds)) + 1;
+    std::size_t fit = REWIND_HISTORY_BYTES / estimatedSnapshotBytes(config);
+    return std::max<std::size_t>(2, std::min(slots, fit));
+}
+
+// Copies the visible entities, reusing the snapshot's storage
+void copySprites(const EntityArrays& e, std::vector<SpriteState>& out) {
+    out.clear();
+    for (std::size_t i = 0; i < e.size(); ++i) {
+        if (e.hidden(i)) continue;
+        out.push_back({e.previousX[i], e.x[i], e.y[i], e.w[i], e.h[i], e.type[i]});
+    }
+}
+
+} // namespace
+
+float RenderSnapshot::alpha(Clock::time_point now) const {
+    if (gameOver) return 1.0f;
+    float sinceTick = std::chrono::duration<float>(now - tickTime).count();
+    return std::min(1.0f, std::max(0.0f, sinceTick / tickSeconds));
+}
+
+void copyWorld(const World& world, RenderSnapshot& s) {
+    copySprites(world.platforms, s.platforms);
+    copySprites(world.coins, s.coins);
+    copySprites(world.obstacles, s.obstacles);
+    s.scrolled = world.scrolled;
+    s.previousScrolled = world.previousScrolled;
+    s.playerX = world.player.x;
+    s.playerY = world.player.y;
+    s.playerPreviousY = world.player.previousY;
+    s.elapsed = world.elapsed;
+    s.previousElapsed = std::max(0.0f, world.elapsed - world.config.tickSeconds);
+    s.playerAirborne = world.player.airborne;
+    s.playerAirborneChangedAt = world.player.airborneChangedAt;
+    s.lives = world.lives;
+    s.coinCount = world.coinCount;
+    s.gameEndTime = world.gameEndTime;
+    s.gameOver = world.gameOver;
+}
+
+SimulationThread::SimulationThread(const SimConfig& config_, ChunkSource* chunkSource, const Replay* playback_,
+                                   float replaySpeed_, bool practice_)
+    : config(config_),
+      playback(playback_),
+      replaySpeed(replaySpeed_),
+      practice(practice_),
+      history(practice_ ? rewindSlots(config_) : 0) {
+    world.config = config;
+    world.chunkSource = chunkSource;
+    resetWorld(world, 0);
+    publish(Clock::now());
+    thread = std::thread(&SimulationThread::run, this);
+}
+
+SimulationThread::~SimulationThread() {
+    running = false;
+    wakeUp();
+    thread.join();
+}
+
+void SimulationThread::wakeUp() {
+    // Through the mutex, so the thread is either still checking or already waiting
+    { std::lock_guard<std::mutex> lock(wakeMutex); }
+    wake.notify_one();
+}
+
+void SimulationThread::startRun(unsigned int seed) {
+    while (!commands.push({Command::StartRun, seed})) std::this_thread::yield();
+    wakeUp();
+}
+
+void SimulationThread::startReplay() {
+    while (!commands.push({Command::StartReplay, 0})) std::this_thread::yield();
+    wakeUp();
+}
+
+void SimulationThread::rewind() {
+    while (!commands.push({Command::Rewind, 0})) std::this_thread::yield();
+    wakeUp();
+}
+
+void SimulationThread::retry() {
+    while (!commands.push({Command::Retry, 0})) std::this_thread::yield();
+    wakeUp();
+}
+
+void SimulationThread::execute(const Command& command) {
+    if (command.type == Command::Rewind || command.type == Command::Retry) {
+        if (!practice || replaying) return;
+        if (command.type == Command::Rewind) {
+            history.rewind(world, std::size_t(std::lround(REWIND_STEP_SECONDS / world.config.tickSeconds)));
+        } else {
+            restoreWorld(world, runStart);
+            history.clear();
+            history.push(world);
+            runs++;
+        }
+        // The recording continues from here, so it still replays to the same end
+        recording.jumps.resize(std::size_t(world.tick));
+        return;
+    }
+
+    if (command.type == Command::StartReplay && playback) {
+        replaying = true;
+        ::startReplay(world, *playback); // with the recorded config
+    } else {
+        replaying = false;
+        world.config = config;
+        resetWorld(world, command.seed);
+        recording.begin(command.seed, world.config);
+        if (practice) {
+            captureWorld(world, runStart);
+            history.clear();
+            history.push(world);
+        }
+    }
+    runs++;
+}
+
+void SimulationThread::saveRecording() {
+    recording.finish(world);
+    try {
+        saveReplay("last_run.replay", recording);
+    } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << std::endl; // losing the replay shouldn't end the game
+    }
+}
+
+void SimulationThread::run() {
+    Clock::time_point last = Clock::now();
+    float accumulator = 0.0f;
+
+    while (running.load(std::memory_order_relaxed)) {
+        bool changed = false;
+        while (Command* command = commands.front()) {
+            execute(*command);
+            commands.pop();
+            accumulator = 0.0f;
+            changed = true;
+        }
+
+        Clock::time_point now = Clock::now();
+        float frameTime = std::min(std::chrono::duration<float>(now - last).count(), MAX_FRAME_SECONDS);
+        last = now;
+
+        const float tickSeconds = world.config.tickSeconds;
+        if (paused.load(std::memory_order_relaxed) || world.gameOver) {
+            input.drain();
+            accumulator = 0.0f;
+        } else {
+            accumulator += replaying ? frameTime * replaySpeed : frameTime;
+            if (replaying) input.drain();
+            // Wall time the next tick is due; it gets the key events from before then
+            Clock::time_point tickDue = now - std::chrono::duration_cast<Clock::duration>(
+                                                  std::chrono::duration<float>(accumulator));
+            const Clock::duration tickDuration =
+                std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(tickSeconds));
+            while (accumulator >= tickSeconds && !world.gameOver) {
+                if (replaying && std::uint64_t(world.tick) >= playback->result.tickCount) {
+                    accumulator = 0.0f; // recording ended before the run did; hold the last frame
+                    break;
+                }
+                tickDue += tickDuration;
+                SimInput tickInput = replaying ? playback->input(std::size_t(world.tick)) : input.advance(tickDue);
+                if (!replaying) recording.record(tickInput);
+                StepEvents events = step(world, tickInput);
+                if (practice && !replaying) history.push(world);
+                if (!replaying && input.pressPending()) {
+                    if (events.jumped) {
+                        jumpPressTime = input.takePress();
+                        pressedJumps++;
+                    } else if (world.player.jumpBufferedUntil < world.tick) {
+                        input.takePress(); // buffer ran out in the air, that press never jumped
+                    }
+                }
+                coinPickups += std::uint64_t(events.coinsCollected);
+                if (events.obstacleHit) obstacleHits++;
+                if (events.gameOver) {
+                    gameOvers++;
+                    if (!replaying) saveRecording();
+                }
+                accumulator -= tickSeconds;
+                changed = true;
+            }
+        }
+
+        // The last tick was due `accumulator` ago
+        Clock::time_point tickTime = now - std::chrono::duration_cast<Clock::duration>(
+                                               std::chrono::duration<float>(accumulator));
+        if (changed) publish(tickTime);
+
+        if (paused.load(std::memory_order_relaxed) || world.gameOver) {
+            // Nothing to tick: sleep until resumed, sent a command (a new run) or stopped
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wake.wait(lock, [&] {
+                    return !running.load(std::memory_order_relaxed) || commands.front() ||
+                           (!paused.load(std::memory_order_relaxed) && !world.gameOver);
+                });
+            }
+            input.drain(); // keys pressed while paused don't carry into the run
+            last = Clock::now(); // the time asleep isn't owed as ticks
+            continue;
+        }
+
+        // Sleep until the next tick is due
+        float untilNextTick = (tickSeconds - accumulator) / (replaying ? replaySpeed : 1.0f);
+        std::this_thread::sleep_until(now + std::chrono::duration_cast<Clock::duration>(
+                                                std::chrono::duration<float>(std::max(0.0f, untilNextTick))));
+    }
+}
+
+void SimulationThread::publish(Clock::time_point tickTime) {
+    RenderSnapshot& s = snapshots.back();
+    copyWorld(world, s);
+    s.replaying = replaying;
+    s.practice = practice;
+    s.rewindSeconds = history.size() > 0 ? (history.size() - 1) * world.config.tickSeconds : 0.0f;
+    s.seed = replaying ? playback->seed : recording.seed;
+    s.tickTime = tickTime;
+    s.tickSeconds = world.config.tickSeconds / (replaying ? replaySpeed : 1.0f);
+    s.coinPickups = coinPickups;
+    s.obstacleHits = obstacleHits;
+    s.gameOvers = gameOvers;
+    s.runs = runs;
+    s.pressedJumps = pressedJumps;
+    s.jumpPressTime = jumpPressTime;
+    snapshots.publish();
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "input_timeline.hpp"
+#include "replay.hpp"
+#include "simulation.hpp"
+#include "spsc_queue.hpp"
+#include "triple_buffer.hpp"
+#include "world_snapshot.hpp"
+
+// One sprite's worth of entity state, as drawn
+struct SpriteState {
+    float previousX, x, y, w, h;
+    std::uint8_t type;
+};
+
+// Everything the render thread needs for a frame, copied out of the World after a tick
+struct RenderSnapshot {
+    std::vector<SpriteState> platforms, coins, obstacles; // visible ones only
+    double scrolled = 0.0, previousScrolled = 0.0;        // for the parallax layers
+    float playerX = 0.0f, playerY = 0.0f, playerPreviousY = 0.0f;
+    // Animations run on simulation time (so they freeze with the game), interpolated like the rest
+    float elapsed = 0.0f, previousElapsed = 0.0f;
+    bool playerAirborne = false;
+    float playerAirborneChangedAt = 0.0f;
+
+    int lives = 0;
+    int coinCount = 0;
+    float gameEndTime = 0.0f;
+    bool gameOver = false;
+    bool replaying = false;
+    bool practice = false;
+    float rewindSeconds = 0.0f; // how far back a rewind can go right now
+    unsigned int seed = 0;
+
+    // Wall time the last tick was due; the renderer interpolates from here
+    std::chrono::steady_clock::time_point tickTime;
+    float tickSeconds = 1.0f / 60.0f;
+
+    // Totals since the thread started, so the renderer can tell what happened since it last looked
+    std::uint64_t coinPickups = 0; // coins, not ticks: several can be picked up in one tick
+    std::uint64_t obstacleHits = 0;
+    std::uint64_t gameOvers = 0;
+    std::uint64_t runs = 0; // runs started
+
+    // Jumps started by a key press, and when the newest one's key went down, for
+    // measuring input-to-present latency
+    std::uint64_t pressedJumps = 0;
+    std::chrono::steady_clock::time_point jumpPressTime;
+
+    // Between the last two ticks, 0..1, for the given wall time
+    float alpha(std::chrono::steady_clock::time_point now) const;
+};
+
+// Copies what is drawn of the world (entities, scroll, player, HUD values) into a
+// snapshot, reusing its storage. The counters and timing fields are left alone.
+void copyWorld(const World& world, RenderSnapshot& snapshot);
+
+// Practice mode: the last few seconds can be rewound, and the run restarted on the same level.
+// The history is one snapshot per tick, so it is capped in bytes too: at high tick rates it
+// reaches back less than REWIND_HISTORY_SECONDS. Big --stress worlds are refused outright,
+// since every tick copies the whole world.
+const float REWIND_HISTORY_SECONDS = 5.0f;
+const float REWIND_STEP_SECONDS = 2.0f; // per rewind()
+const std::size_t REWIND_HISTORY_BYTES = std::size_t(64) << 20;
+const int MAX_PRACTICE_STRESS_ENTITIES = 1000;
+
+// Runs the simulation on its own thread at the fixed tick rate.
+//
+// The main thread sends commands (new run, replay) and timestamped key events through
+// lock-free queues, sets the pause flag, and reads snapshots from a lock-free triple
+// buffer. A stall in the main thread (window.display() waiting on the driver) doesn't
+// delay ticks, and input is still applied at the tick it happened in.
+class SimulationThread {
+public:
+    // playback may be null; config and chunkSource are used for every run.
+    // practice keeps a per-tick snapshot history for rewind() and retry().
+    SimulationThread(const SimConfig& config, ChunkSource* chunkSource, const Replay* playback, float replaySpeed,
+                     bool practice);
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    void startRun(unsigned int seed);
+    void startReplay();
+    // Practice mode only: back REWIND_STEP_SECONDS (also out of a game over), and back to the
+    // start of the current level. Both restore snapshots, so they take effect on the next tick.
+    void rewind();
+    void retry();
+
+    // From the main thread, as events are polled
+    void pushInput(const InputEvent& event) { input.push(event); }
+    // Set every frame from the main thread
+    void setPaused(bool paused_) {
+        if (paused.exchange(paused_, std::memory_order_relaxed) != paused_) wakeUp();
+    }
+
+    // Newest snapshot (the same one again if no tick happened since)
+    const RenderSnapshot& latest() {
+        snapshots.acquire();
+        return snapshots.front();
+    }
+
+private:
+    struct Command {
+        enum Type { StartRun, StartReplay, Rewind, Retry } type;
+        unsigned int seed;
+    };
+
+    void run();
+    void execute(const Command& command);
+    void publish(std::chrono::steady_clock::time_point tickTime);
+    void saveRecording();
+    void wakeUp();
+
+    SimConfig config; // for new runs; replays bring their own
+    World world;
+    const Replay* playback;
+    float replaySpeed;
+    bool replaying = false;
+    const bool practice;
+    RewindBuffer history;     // practice: the last REWIND_HISTORY_SECONDS of ticks (or REWIND_HISTORY_BYTES)
+    WorldSnapshot runStart;   // practice: the current run at tick 0
+    Replay recording;
+    std::uint64_t coinPickups = 0, obstacleHits = 0, gameOvers = 0, runs = 0;
+    std::uint64_t pressedJumps = 0;
+    std::chrono::steady_clock::time_point jumpPressTime;
+
+    SpscQueue<Command, 8> commands;
+    TripleBuffer<RenderSnapshot> snapshots;
+    InputTimeline input;
+    std::atomic<bool> paused{true};
+    std::atomic<bool> running{true};
+    // While paused or game over the thread sleeps on this until resumed, sent a command or stopped
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::thread thread;
+};
@@ -0,0 +1,447 @@
+#include "simulation.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "collision_kernel.hpp"
+
+namespace {
+
+struct Box {
+    float left, top, width, height;
+};
+
+// Same test as sf::FloatRect::intersects
+bool intersects(const Box& a, const EntityArrays& e, std::size_t i) {
+    return a.left < e.x[i] + e.w[i] && e.x[i] < a.left + a.width &&
+           a.top < e.y[i] + e.h[i] && e.y[i] < a.top + a.height;
+}
+
+// Per-thread scratch for the narrowphase, reused every tick
+thread_local PackedBounds candidates;
+thread_local std::vector<std::uint64_t> hits;
+
+// Packs the broadphase candidates near [minX, maxX], in x order
+void gatherCandidates(const AxisIndex& index, const EntityArrays& e, float minX, float maxX) {
+    candidates.clear();
+    index.query(minX, maxX, [&](std::size_t i) {
+        candidates.push(std::uint32_t(i), e.x[i], e.y[i], e.w[i], e.h[i]);
+    });
+}
+
+Box playerBox(const World& world) {
+    return {world.player.x, world.player.y, float(FRAME_WIDTH), float(FRAME_HEIGHT)};
+}
+
+// Uniform in [lo, hi). The std distributions are implementation-defined, so the same
+// seed would give different levels on different standard libraries; this doesn't.
+float randomFloat(std::mt19937& rng, float lo, float hi) {
+    return lo + (hi - lo) * float(rng() >> 8) * (1.0f / 16777216.0f);
+}
+
+float randomPlatformX(std::mt19937& rng) {
+    return randomFloat(rng, 150, WINDOW_WIDTH - PLATFORM_WIDTH - 50);
+}
+
+float randomPlatformY(std::mt19937& rng) {
+    return randomFloat(rng, 200, GROUND_Y - 80);
+}
+
+// Moves every entity left by dx, remembering where it was for interpolation
+void scroll(EntityArrays& e, float dx) {
+    const std::size_t n = e.size();
+    float* x = e.x.data();
+    float* previousX = e.previousX.data();
+    for (std::size_t i = 0; i < n; ++i) {
+        previousX[i] = x[i];
+        x[i] -= dx;
+    }
+}
+
+float rightmostX(const EntityArrays& e) {
+    float maxX = 0;
+    for (float x : e.x) maxX = std::max(maxX, x);
+    return maxX;
+}
+
+// Extra coins and obstacles for stress runs, spread over the next few screens
+void addStressEntities(World& world, int count) {
+    for (int i = 0; i < count; ++i) {
+        float y = randomFloat(world.rng, 200, GROUND_Y - OBSTACLE_SIZE);
+        world.coins.add(200.0f + i * 24.0f, y, world.config.coinWidth, world.config.coinHeight);
+        std::uint8_t type = std::uint8_t(1 + world.rng() % 2);
+        float size = obstacleSize(type);
+        world.obstacles.add(WINDOW_WIDTH + 300.0f + i * 60.0f, GROUND_Y - OBSTACLE_SIZE, size, size, type);
+    }
+}
+
+// Takes a free slot in e (moving it in the index), or adds one
+void spawn(EntityArrays& e, AxisIndex& index, std::vector<std::uint32_t>& freeSlots,
+           float x, float y, float w, float h, std::uint8_t type) {
+    if (freeSlots.empty()) {
+        e.add(x, y, w, h, type);
+        return;
+    }
+    std::uint32_t i = freeSlots.back();
+    freeSlots.pop_back();
+    float oldX = e.x[i];
+    e.x[i] = x;
+    e.previousX[i] = x;
+    e.y[i] = y;
+    e.w[i] = w;
+    e.h[i] = h;
+    e.type[i] = type;
+    e.flags[i] = 0;
+    index.relocate(i, oldX, x, w);
+}
+
+// Streamed level: frees the slots of entities that scrolled off the left edge
+void freeOffscreen(EntityArrays& e, std::vector<std::uint32_t>& freeSlots) {
+    for (std::size_t i = 0; i < e.size(); ++i) {
+        if ((e.flags[i] & ENTITY_FREE) == 0 && e.x[i] + e.w[i] < -50.0f) {
+            e.flags[i] = ENTITY_FREE | ENTITY_HIDDEN;
+            freeSlots.push_back(std::uint32_t(i));
+        }
+    }
+}
+
+// Streamed level: spawns chunks until the level reaches a screen past the right edge
+void streamLevel(World& world) {
+    const SimConfig& config = world.config;
+    while (world.levelEndX < WINDOW_WIDTH * 2) {
+        LevelChunk chunk;
+        if (!world.chunkSource || !world.chunkSource->take(world.levelSeed, world.nextChunk, chunk)) {
+            chunk = generateChunk(world.levelSeed, world.nextChunk, config.platformWidth);
+        }
+        const float originX = world.levelEndX;
+
+        for (int i = 0; i < chunk.platformCount; ++i) {
+            const ChunkSpawn& p = chunk.platforms[i];
+            spawn(world.platforms, world.platformIndex, world.freePlatforms,
+                  originX + p.x, p.y, config.platformWidth, config.platformHeight, 0);
+        }
+        for (int i = 0; i < chunk.coinCount; ++i) {
+            const ChunkSpawn& c = chunk.coins[i];
+            spawn(world.coins, world.coinIndex, world.freeCoins,
+                  originX + c.x, c.y, config.coinWidth, config.coinHeight, 0);
+        }
+        for (int i = 0; i < chunk.obstacleCount; ++i) {
+            const ChunkSpawn& o = chunk.obstacles[i];
+            float size = obstacleSize(o.type);
+            spawn(world.obstacles, world.obstacleIndex, world.freeObstacles,
+                  originX + o.x, o.y, size, size, o.type);
+        }
+
+        // Slots added past the end aren't in the indices yet
+        if (world.platformIndex.size() != world.platforms.size()) world.platformIndex.rebuild(world.platforms.x, world.platforms.w);
+        if (world.coinIndex.size() != world.coins.size()) world.coinIndex.rebuild(world.coins.x, world.coins.w);
+        if (world.obstacleIndex.size() != world.obstacles.size()) world.obstacleIndex.rebuild(world.obstacles.x, world.obstacles.w);
+
+        world.levelEndX += CHUNK_WIDTH;
+        world.nextChunk++;
+    }
+}
+
+// The original level: a fixed set of platforms, coins and obstacles
+void addRecycledLevel(World& world) {
+    const SimConfig& config = world.config;
+
+    // --- Platforms setup ---
+    for (int i = 0; i < 5; ++i) {
+        float randX = randomPlatformX(world.rng) + i * 120; // Spread out a bit horizontally
+        float randY = randomPlatformY(world.rng);
+        world.platforms.add(randX, randY, config.platformWidth, config.platformHeight);
+    }
+    const EntityArrays& p = world.platforms;
+
+    // Place coins just above platforms or ground (different positions from obstacles)
+    EntityArrays& coins = world.coins;
+    coins.add(p.x[0] + 20, p.y[0] - COIN_SIZE - 15, config.coinWidth, config.coinHeight);  // Left side
+    coins.add(p.x[1] + 130, p.y[1] - COIN_SIZE - 15, config.coinWidth, config.coinHeight); // Right side
+    coins.add(p.x[2] + 20, p.y[2] - COIN_SIZE - 15, config.coinWidth, config.coinHeight);  // Left side
+    coins.add(p.x[3] + 130, p.y[3] - COIN_SIZE - 15, config.coinWidth, config.coinHeight); // Right side
+    coins.add(650, GROUND_Y - COIN_SIZE - 15, config.coinWidth, config.coinHeight);        // Ground coin - different position
+
+    // Place obstacles on platforms or ground (starting off-screen)
+    EntityArrays& obstacles = world.obstacles;
+    const float size1 = obstacleSize(1), size2 = obstacleSize(2);
+    obstacles.add(WINDOW_WIDTH + 300.0f, p.y[0] - OBSTACLE_SIZE, size1, size1, 1);    // obstacle1 on platform 1
+    obstacles.add(WINDOW_WIDTH + 600.0f, GROUND_Y - OBSTACLE_SIZE, size2, size2, 2);  // obstacle2 on ground only
+    obstacles.add(WINDOW_WIDTH + 900.0f, p.y[2] - OBSTACLE_SIZE, size1, size1, 1);    // obstacle1 on platform 3
+    obstacles.add(WINDOW_WIDTH + 1200.0f, GROUND_Y - OBSTACLE_SIZE, size2, size2, 2); // obstacle2 on ground only
+}
+
+} // namespace
+
+std::size_t EntityArrays::add(float x_, float y_, float w_, float h_, std::uint8_t type_) {
+    x.push_back(x_);
+    y.push_back(y_);
+    w.push_back(w_);
+    h.push_back(h_);
+    previousX.push_back(x_);
+    type.push_back(type_);
+    flags.push_back(0);
+    return x.size() - 1;
+}
+
+void EntityArrays::clear() {
+    x.clear();
+    y.clear();
+    w.clear();
+    h.clear();
+    previousX.clear();
+    type.clear();
+    flags.clear();
+}
+
+float obstacleSize(int type) {
+    // Make obstacle2 (type 2) a bit larger (1.3x)
+    return type == 2 ? 1.3f * OBSTACLE_SIZE : float(OBSTACLE_SIZE);
+}
+
+void resetWorld(World& world, unsigned int seed) {
+    // Start from a fresh World, but keep the entity arrays' storage
+    World fresh;
+    fresh.config = world.config;
+    fresh.chunkSource = world.chunkSource;
+    std::swap(fresh.platforms, world.platforms);
+    std::swap(fresh.coins, world.coins);
+    std::swap(fresh.obstacles, world.obstacles);
+    std::swap(fresh.freePlatforms, world.freePlatforms);
+    std::swap(fresh.freeCoins, world.freeCoins);
+    std::swap(fresh.freeObstacles, world.freeObstacles);
+    world = std::move(fresh);
+    world.platforms.clear();
+    world.coins.clear();
+    world.obstacles.clear();
+    world.freePlatforms.clear();
+    world.freeCoins.clear();
+    world.freeObstacles.clear();
+    world.rng.seed(seed);
+    const SimConfig& config = world.config;
+
+    if (config.levelMode == LevelMode::Recycled) {
+        addRecycledLevel(world);
+    } else {
+        world.levelSeed = seed;
+        streamLevel(world);
+    }
+
+    if (config.stressEntities > 0) addStressEntities(world, config.stressEntities);
+
+    world.platformIndex.rebuild(world.platforms.x, world.platforms.w);
+    world.coinIndex.rebuild(world.coins.x, world.coins.w);
+    world.obstacleIndex.rebuild(world.obstacles.x, world.obstacles.w);
+}
+
+StepEvents step(World& world, const SimInput& input) {
+    StepEvents events;
+    if (world.gameOver) return events;
+
+    world.tick++;
+    world.elapsed = world.tick * world.config.tickSeconds;
+
+    // Calculate game speed based on time - gradual increase every speedStepSeconds
+    const DifficultyParams& difficulty = world.config.difficulty;
+    float elapsedTime = world.elapsed;
+    if (elapsedTime > difficulty.speedStepSeconds) {
+        // Gradual speed increase by speedStep every speedStepSeconds
+        float speedMultiplier = 1.0f + (std::floor(elapsedTime / difficulty.speedStepSeconds) * difficulty.speedStep);
+        world.gameSpeed = std::min(speedMultiplier, difficulty.maxSpeed); // Capped
+    } else {
+        world.gameSpeed = 1.0f; // Normal speed for the first step
+    }
+
+    // Tuned per 60 Hz frame, so scale by how much of one this tick covers
+    const float frameScale = world.config.tickSeconds * REFERENCE_TICK_RATE;
+    world.currentSpeed = BASE_SPEED * world.gameSpeed;
+    float currentSpeed = world.currentSpeed * frameScale;
+
+    // Entities added outside resetWorld (tools, tests) need their index rebuilt
+    if (world.platformIndex.size() != world.platforms.size()) world.platformIndex.rebuild(world.platforms.x, world.platforms.w);
+    if (world.coinIndex.size() != world.coins.size()) world.coinIndex.rebuild(world.coins.x, world.coins.w);
+    if (world.obstacleIndex.size() != world.obstacles.size()) world.obstacleIndex.rebuild(world.obstacles.x, world.obstacles.w);
+
+    // Background layers only need to know how far the level has moved
+    world.previousScrolled = world.scrolled;
+    world.scrolled += currentSpeed;
+
+    EntityArrays& platforms = world.platforms;
+    EntityArrays& obstacles = world.obstacles;
+    EntityArrays& coins = world.coins;
+    if (world.config.levelMode == LevelMode::Streamed) {
+        // Everything scrolls together; slots that leave the screen are reused by later chunks
+        scroll(platforms, currentSpeed);
+        scroll(coins, currentSpeed);
+        scroll(obstacles, currentSpeed);
+        world.platformIndex.scroll(currentSpeed);
+        world.coinIndex.scroll(currentSpeed);
+        world.obstacleIndex.scroll(currentSpeed);
+        world.levelEndX -= currentSpeed;
+        freeOffscreen(platforms, world.freePlatforms);
+        freeOffscreen(coins, world.freeCoins);
+        freeOffscreen(obstacles, world.freeObstacles);
+        streamLevel(world);
+    } else {
+        // Move platforms to the left, loop them behind the rightmost one
+        scroll(platforms, currentSpeed);
+        world.platformIndex.scroll(currentSpeed);
+        float maxPlatformX = rightmostX(platforms);
+        for (std::size_t i = 0; i < platforms.size(); ++i) {
+            if (platforms.x[i] < -PLATFORM_WIDTH) {
+                float oldX = platforms.x[i];
+                platforms.y[i] = randomPlatformY(world.rng);
+                platforms.x[i] = maxPlatformX + 300 + randomPlatformX(world.rng) / 2; // Randomize both X gap and Y
+                maxPlatformX = platforms.x[i];
+                world.platformIndex.relocate(i, oldX, platforms.x[i], platforms.w[i]);
+            }
+        }
+
+        // Move obstacles to the left, loop them (only after obstacleStartSeconds)
+        if (elapsedTime > difficulty.obstacleStartSeconds) {
+            scroll(obstacles, currentSpeed);
+            world.obstacleIndex.scroll(currentSpeed);
+            float maxObstacleX = rightmostX(obstacles);
+            for (std::size_t i = 0; i < obstacles.size(); ++i) {
+                if (obstacles.x[i] >= -OBSTACLE_SIZE) continue;
+
+                // Set Y position based on obstacle type
+                float newY;
+                if (obstacles.type[i] == 2) {
+                    newY = GROUND_Y - OBSTACLE_SIZE; // Type 2 obstacles only on ground
+                } else {
+                    // Type 1 obstacles can be on a platform or the ground (one extra choice)
+                    std::size_t randomChoice = world.rng() % (platforms.size() + 1);
+                    if (randomChoice < platforms.size()) {
+                        newY = platforms.y[randomChoice] - OBSTACLE_SIZE; // On platform
+                    } else {
+                        newY = GROUND_Y - OBSTACLE_SIZE; // On ground
+                    }
+                }
+
+                float oldX = obstacles.x[i];
+                obstacles.x[i] = maxObstacleX + 500; // More spacing
+                obstacles.y[i] = newY;
+                obstacles.flags[i] &= ~ENTITY_HIDDEN; // Visible again when recycled
+                maxObstacleX = obstacles.x[i];
+                world.obstacleIndex.relocate(i, oldX, obstacles.x[i], obstacles.w[i]);
+            }
+        }
+
+        // Move coins to the left, loop them (ensure they keep coming)
+        scroll(coins, currentSpeed);
+        world.coinIndex.scroll(currentSpeed);
+        float maxCoinX = rightmostX(coins);
+        for (std::size_t i = 0; i < coins.size(); ++i) {
+            if (coins.x[i] < -COIN_SIZE) {
+                float oldX = coins.x[i];
+                coins.x[i] = maxCoinX + 350;
+                coins.flags[i] &= ~ENTITY_HIDDEN; // Reset collected status when recycling
+                maxCoinX = coins.x[i];
+                world.coinIndex.relocate(i, oldX, coins.x[i], coins.w[i]);
+            }
+        }
+    }
+
+    Player& player = world.player;
+    player.previousY = player.y;
+
+    //Jump
+    // A press is remembered for a moment so it still counts if it came just before landing,
+    // and a jump is still allowed for a moment after running off an edge.
+    const long bufferTicks = std::lround(JUMP_BUFFER_SECONDS / world.config.tickSeconds);
+    const long coyoteTicks = std::lround(COYOTE_SECONDS / world.config.tickSeconds);
+    // (+1: a landing during the last buffered tick jumps on the tick after)
+    if (input.jumpPressed) player.jumpBufferedUntil = world.tick + bufferTicks + 1;
+    bool wantsJump = input.jump || world.tick <= player.jumpBufferedUntil;
+    // lastGroundedTick is at most the previous tick here, standing still counts as 1 tick ago
+    bool canJump = !player.isJumping && world.tick - player.lastGroundedTick <= coyoteTicks + 1;
+    if (wantsJump && canJump) {
+        player.velocityY = JUMP_VELOCITY;
+        player.isJumping = true;
+        player.jumpBufferedUntil = -1;
+        events.jumped = true;
+    }
+
+    //Gravity
+    player.velocityY += GRAVITY * frameScale;
+    player.y += player.velocityY * frameScale;
+
+    // Broadphase: only entities near the player's x-range get the AABB tests below.
+    // Player bounds are computed once, and only refreshed when a landing moves the player.
+    Box playerBounds = playerBox(world);
+    const float playerLeft = playerBounds.left;
+    const float playerRight = playerBounds.left + playerBounds.width;
+
+    //Landing on ground or platforms
+    // Candidates are tested in one batch against the bounds before any landing; once a
+    // landing moves the player, the rest fall back to the exact scalar test.
+    gatherCandidates(world.platformIndex, platforms, playerLeft, playerRight);
+    overlapMask(playerBounds.left, playerBounds.top, playerBounds.width, playerBounds.height, candidates, hits);
+    bool landed = false;
+    for (std::size_t c = 0; c < candidates.size(); ++c) {
+        std::size_t i = candidates.entity[c];
+        bool overlaps = landed ? intersects(playerBounds, platforms, i) : maskBit(hits, c);
+        if (overlaps && !platforms.hidden(i) &&
+            player.velocityY >= 0 &&
+            playerBounds.top + playerBounds.height - 10 < platforms.y[i] + 10) {
+            player.y = platforms.y[i] - playerBounds.height;
+            player.velocityY = 0;
+            player.isJumping = false;
+            player.lastGroundedTick = world.tick;
+            playerBounds = playerBox(world);
+            landed = true;
+        }
+    }
+    // Ground landing
+    if (player.y >= GROUND_Y - FRAME_HEIGHT) {
+        player.y = GROUND_Y - FRAME_HEIGHT;
+        player.velocityY = 0;
+        player.isJumping = false;
+        player.lastGroundedTick = world.tick;
+        playerBounds = playerBox(world);
+    }
+
+    // Takeoffs and landings (also running off an edge), which switch the player's animation
+    const bool airborne = player.lastGroundedTick != world.tick;
+    if (airborne != player.airborne) {
+        player.airborne = airborne;
+        player.airborneChangedAt = elapsedTime;
+    }
+
+    // --- Coin collection ---
+    gatherCandidates(world.coinIndex, coins, playerLeft, playerRight);
+    overlapMask(playerBounds.left, playerBounds.top, playerBounds.width, playerBounds.height, candidates, hits);
+    for (std::size_t c = 0; c < candidates.size(); ++c) {
+        std::size_t i = candidates.entity[c];
+        if (maskBit(hits, c) && !coins.hidden(i)) {
+            coins.flags[i] |= ENTITY_HIDDEN;
+            world.coinCount++;
+            events.coinsCollected++;
+        }
+    }
+
+    // --- Obstacle collision (only after obstacleStartSeconds, one hit per cooldown) ---
+    if (elapsedTime > difficulty.obstacleStartSeconds && elapsedTime - world.lastHitTime > difficulty.hitCooldownSeconds) {
+        gatherCandidates(world.obstacleIndex, obstacles, playerLeft, playerRight);
+        overlapMask(playerBounds.left, playerBounds.top, playerBounds.width, playerBounds.height, candidates, hits);
+        for (std::size_t c = 0; c < candidates.size(); ++c) {
+            std::size_t i = candidates.entity[c];
+            if (!maskBit(hits, c) || obstacles.hidden(i)) continue;
+            world.lives--;
+            world.lastHitTime = elapsedTime;
+            obstacles.flags[i] |= ENTITY_HIDDEN;
+            events.obstacleHit = true;
+            if (world.lives <= 0) {
+                world.gameOver = true;
+                events.gameOver = true;
+            }
+            break;
+        }
+    }
+
+    if (!world.gameOver) {
+        world.gameEndTime = elapsedTime;
+    }
+    return events;
+}
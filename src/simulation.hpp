@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "broadphase.hpp"
+#include "config.hpp"
+#include "level_generator.hpp"
+
+// Headless game simulation.
+// Holds everything that moves or collides, and advances it one tick at a time.
+// Nothing in here touches SFML, so it can run without a window, audio or textures.
+
+// Where platforms, coins and obstacles come from
+enum class LevelMode {
+    Streamed, // seeded chunks generated ahead of the camera (level_generator.hpp)
+    Recycled, // the original fixed set of entities, moved back to the right as they leave
+};
+
+// The difficulty curve. gameSpeed is 1 for the first speedStepSeconds, then goes up by
+// speedStep every speedStepSeconds until maxSpeed. Defaults are the hand-tuned values.
+struct DifficultyParams {
+    float speedStepSeconds = 10.0f;
+    float speedStep = 0.3f;
+    float maxSpeed = 3.0f;
+    float obstacleStartSeconds = 5.0f; // obstacles move / hurt only after this
+    float hitCooldownSeconds = 0.7f;   // no second hit this soon after one
+};
+
+// Simulation settings. The windowed game fills the collision box sizes from the
+// loaded textures, the defaults match the images shipped in assets/.
+struct SimConfig {
+    float platformWidth = 300.0f;  // assets/platform.png
+    float platformHeight = 30.0f;
+    float coinWidth = 32.0f;       // assets/coin.png
+    float coinHeight = 34.0f;
+    float tickSeconds = 1.0f / 60.0f; // fixed simulation step, independent of the render rate
+    int stressEntities = 0;           // extra coins and obstacles spawned per run, for stress testing (up to MAX_STRESS_ENTITIES)
+    LevelMode levelMode = LevelMode::Streamed;
+    DifficultyParams difficulty;
+};
+
+const int MAX_STRESS_ENTITIES = 100000;
+const float MAX_TICK_RATE = 1000.0f; // Hz, the most --tick-rate allows
+
+// Speeds, gravity and the jump velocity are tuned in pixels per 1/60 s frame.
+const float REFERENCE_TICK_RATE = 60.0f;
+
+struct SimInput {
+    bool jump = false;        // held at the end of the tick
+    bool jumpPressed = false; // pressed during the tick (even if already released again)
+};
+
+// What happened during one step, so the caller can play sounds etc.
+struct StepEvents {
+    int coinsCollected = 0;
+    bool obstacleHit = false;
+    bool gameOver = false;
+    bool jumped = false;
+};
+
+struct Player {
+    float x = 100.0f;
+    float y = GROUND_Y - FRAME_HEIGHT;
+    float previousY = GROUND_Y - FRAME_HEIGHT; // y one tick back, for render interpolation
+    float velocityY = 0.0f;
+    bool isJumping = false;
+    long lastGroundedTick = 0;    // last tick spent standing on something, for coyote time
+    long jumpBufferedUntil = -1;  // last tick a buffered press can still jump on
+    bool airborne = false;
+    float airborneChangedAt = -1000.0f; // elapsed at the last takeoff or landing, for the animations
+};
+
+// Entity flags
+const std::uint8_t ENTITY_HIDDEN = 1; // collected coin, or obstacle that already hit the player
+const std::uint8_t ENTITY_FREE = 2;   // streamed level: slot scrolled off screen, waiting for reuse (also hidden)
+
+// Struct-of-arrays storage for one kind of entity (platforms, coins or obstacles).
+// Entity i is x[i], y[i], ...; update loops are plain linear passes over the arrays.
+// previousX holds x one tick back, for render interpolation.
+struct EntityArrays {
+    std::vector<float> x, y, w, h, previousX;
+    std::vector<std::uint8_t> type;
+    std::vector<std::uint8_t> flags;
+
+    std::size_t size() const { return x.size(); }
+    bool hidden(std::size_t i) const { return (flags[i] & ENTITY_HIDDEN) != 0; }
+
+    std::size_t add(float x_, float y_, float w_, float h_, std::uint8_t type_ = 0);
+    void clear();
+};
+
+struct World {
+    SimConfig config;
+    std::mt19937 rng;
+
+    long tick = 0;
+    float elapsed = 0.0f;         // simulated seconds since the run started
+    float gameSpeed = 1.0f;       // Base speed multiplier
+    float currentSpeed = 0.0f;    // pixels per 1/60 s this tick
+    double scrolled = 0.0;         // pixels the level has moved left since the run started
+    double previousScrolled = 0.0; // one tick back; the renderer's parallax layers follow these
+    float gameEndTime = 0.0f;
+    float lastHitTime = -1000.0f; // for the obstacle collision cooldown
+
+    int lives = MAX_LIVES;
+    int coinCount = 0;
+    bool gameOver = false;
+
+    Player player;
+
+    EntityArrays platforms;
+    EntityArrays coins;
+    EntityArrays obstacles; // type is 1 or 2
+
+    // Broadphase indices for player-versus-world queries, kept in step with the arrays
+    AxisIndex platformIndex;
+    AxisIndex coinIndex;
+    AxisIndex obstacleIndex;
+
+    // Streamed level: the next chunk to spawn, and the screen x the spawned level reaches
+    std::uint64_t levelSeed = 0;
+    int nextChunk = 0;
+    float levelEndX = 0.0f;
+    ChunkSource* chunkSource = nullptr; // optional, kept across resets; chunks are generated here when null
+    std::vector<std::uint32_t> freePlatforms, freeCoins, freeObstacles; // reusable slots
+};
+
+const float BASE_SPEED = 2.34f * 1.5f; // 1.5x faster initial speed
+const float JUMP_VELOCITY = -10.0f;
+const float COYOTE_SECONDS = 0.08f;      // jump still allowed this long after running off an edge
+const float JUMP_BUFFER_SECONDS = 0.1f;  // a press this long before landing jumps on landing
+
+// Puts the world back at the start of a run. Same seed, same level.
+// config and chunkSource are kept.
+void resetWorld(World& world, unsigned int seed);
+
+// Advances the world by one tick.
+StepEvents step(World& world, const SimInput& input);
+
+// Side length of an obstacle's (square) collision box
+float obstacleSize(int type);
+
+// Position to draw an entity at, between the previous and current tick.
+// Entities only move left, so a jump to the right means it was recycled (or its slot reused
+// by a new chunk) and is drawn where it is now.
+inline float interpolateX(float previous, float current, float alpha) {
+    return current > previous ? current : previous + (current - previous) * alpha;
+}
+
+inline float interpolate(float previous, float current, float alpha) {
+    return previous + (current - previous) * alpha;
+}
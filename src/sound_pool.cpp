@@ -0,0 +1,74 @@
+#include "sound_pool.hpp"
+
+#include <algorithm>
+
+SoundPool::SoundPool(int maxActiveVoices_) : maxActiveVoices(maxActiveVoices_) {}
+
+std::size_t SoundPool::addEffect(const sf::SoundBuffer& buffer, const SoundEffectSettings& settings) {
+    Effect effect{settings, voices.size(), std::size_t(std::max(1, settings.voices))};
+    for (std::size_t i = 0; i < effect.voiceCount; ++i) {
+        voices.emplace_back();
+        voices.back().sound.setBuffer(buffer);
+        voices.back().effect = effects.size();
+    }
+    effects.push_back(effect);
+    return effects.size() - 1;
+}
+
+float SoundPool::variation(float amount) {
+    if (amount <= 0.0f) return 0.0f;
+    // xorshift32, plenty for picking pitches
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    float unit = float(rngState >> 8) * (1.0f / 16777216.0f);
+    return (unit * 2.0f - 1.0f) * amount;
+}
+
+void SoundPool::play(std::size_t effectId) {
+    const Effect& effect = effects[effectId];
+
+    // A free voice of this effect, or else its oldest one
+    Voice* voice = nullptr;
+    for (std::size_t i = effect.firstVoice; i < effect.firstVoice + effect.voiceCount; ++i) {
+        Voice& candidate = voices[i];
+        if (!isPlaying(candidate)) {
+            voice = &candidate;
+            break;
+        }
+        if (!voice || candidate.startedAt < voice->startedAt) voice = &candidate;
+    }
+
+    // A voice that isn't playing yet adds to the total; make room if the pool is full
+    if (!isPlaying(*voice) && activeVoices() >= maxActiveVoices) {
+        Voice* victim = nullptr;
+        for (Voice& candidate : voices) {
+            if (!isPlaying(candidate)) continue;
+            int priority = effects[candidate.effect].settings.priority;
+            if (priority > effect.settings.priority) continue;
+            if (!victim || priority < effects[victim->effect].settings.priority ||
+                (priority == effects[victim->effect].settings.priority && candidate.startedAt < victim->startedAt)) {
+                victim = &candidate;
+            }
+        }
+        if (!victim) return; // everything playing matters more
+        victim->sound.stop();
+    }
+
+    const SoundEffectSettings& s = effect.settings;
+    voice->sound.setPitch(1.0f + variation(s.pitchVariation));
+    voice->sound.setVolume(std::min(100.0f, s.volume * (1.0f + variation(s.volumeVariation))));
+    voice->sound.stop(); // restart from the beginning if it was stolen
+    voice->sound.play();
+    voice->startedAt = ++playCounter;
+}
+
+void SoundPool::stopAll() {
+    for (Voice& voice : voices) voice.sound.stop();
+}
+
+int SoundPool::activeVoices() const {
+    int active = 0;
+    for (const Voice& voice : voices) active += isPlaying(voice) ? 1 : 0;
+    return active;
+}
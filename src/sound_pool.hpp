@@ -0,0 +1,58 @@
+#pragma once
+
+#include <SFML/Audio.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// How one sound effect plays through the pool
+struct SoundEffectSettings {
+    int voices = 1;              // how many copies can play at once
+    int priority = 0;            // higher steals voices from lower when the pool is full
+    float volume = 100.0f;
+    float pitchVariation = 0.0f;  // pitch is 1 +- this, picked per play
+    float volumeVariation = 0.0f; // volume is scaled by 1 +- this
+};
+
+// Pre-allocated sound effect voices.
+//
+// Each effect gets its own voices, bound to its buffer once at setup (binding a
+// buffer allocates in SFML, playing doesn't). Retriggering an effect that is
+// already using all its voices restarts its oldest one instead of cutting off the
+// newest. At most maxActiveVoices play at once across all effects; past that, a new
+// sound stops the oldest one of lower or equal priority, or is dropped.
+// play() doesn't allocate or block.
+class SoundPool {
+public:
+    explicit SoundPool(int maxActiveVoices = 16);
+
+    // Setup only. Returns the id to pass to play().
+    std::size_t addEffect(const sf::SoundBuffer& buffer, const SoundEffectSettings& settings);
+
+    void play(std::size_t effect);
+    void stopAll();
+
+    int activeVoices() const;
+
+private:
+    struct Voice {
+        sf::Sound sound;
+        std::size_t effect = 0;
+        std::uint64_t startedAt = 0; // play order, for picking the oldest
+    };
+    struct Effect {
+        SoundEffectSettings settings;
+        std::size_t firstVoice;
+        std::size_t voiceCount;
+    };
+
+    bool isPlaying(const Voice& voice) const { return voice.sound.getStatus() == sf::Sound::Playing; }
+    float variation(float amount); // uniform in [-amount, amount]
+
+    int maxActiveVoices;
+    std::deque<Voice> voices; // deque: voices never move once created
+    std::vector<Effect> effects;
+    std::uint64_t playCounter = 0;
+    std::uint32_t rngState = 0x9E3779B9u;
+};
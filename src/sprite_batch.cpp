@@ -0,0 +1,43 @@
+#include "sprite_batch.hpp"
+
+std::size_t SpriteBatch::addLayer(const sf::Texture& texture) {
+    layers.push_back({&texture, sf::VertexArray(sf::Quads)});
+    return layers.size() - 1;
+}
+
+void SpriteBatch::clear() {
+    // Keep the layers (and their vertex capacity), just empty them
+    for (auto& layer : layers) layer.vertices.clear();
+}
+
+void SpriteBatch::add(std::size_t layer, const sf::IntRect& textureRect,
+                      float x, float y, float width, float height) {
+    add(layer, sf::FloatRect(textureRect), x, y, width, height);
+}
+
+void SpriteBatch::add(std::size_t layer, const sf::FloatRect& textureRect,
+                      float x, float y, float width, float height) {
+    const float left = textureRect.left;
+    const float top = textureRect.top;
+    const float right = left + textureRect.width;
+    const float bottom = top + textureRect.height;
+    sf::VertexArray& v = layers[layer].vertices;
+    v.append(sf::Vertex(sf::Vector2f(x, y), sf::Vector2f(left, top)));
+    v.append(sf::Vertex(sf::Vector2f(x + width, y), sf::Vector2f(right, top)));
+    v.append(sf::Vertex(sf::Vector2f(x + width, y + height), sf::Vector2f(right, bottom)));
+    v.append(sf::Vertex(sf::Vector2f(x, y + height), sf::Vector2f(left, bottom)));
+}
+
+void SpriteBatch::add(std::size_t layer, float x, float y, float width, float height) {
+    sf::Vector2u size = layers[layer].texture->getSize();
+    add(layer, sf::IntRect(0, 0, int(size.x), int(size.y)), x, y, width, height);
+}
+
+void SpriteBatch::draw(sf::RenderTarget& target) const {
+    lastDrawCalls = 0;
+    for (const auto& layer : layers) {
+        if (layer.vertices.getVertexCount() == 0) continue;
+        target.draw(layer.vertices, sf::RenderStates(layer.texture));
+        lastDrawCalls++;
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <vector>
+
+// Collects textured quads for a frame and submits them with one draw call per layer.
+//
+// Each layer has one texture (several layers may share it, e.g. an atlas drawn both
+// behind and in front of something else). Layers are drawn in the order they were added.
+// The vertex storage is kept between frames, so steady-state frames don't allocate.
+class SpriteBatch {
+public:
+    // Adds a layer on top of the existing ones and returns its index
+    std::size_t addLayer(const sf::Texture& texture);
+
+    // Empties the batch for a new frame
+    void clear();
+
+    // Queues the textureRect part of the layer's texture, stretched to width x height at (x, y)
+    void add(std::size_t layer, const sf::IntRect& textureRect,
+             float x, float y, float width, float height);
+
+    // Same with sub-pixel texture coordinates; with a repeated texture the rect may
+    // reach past the texture's edges
+    void add(std::size_t layer, const sf::FloatRect& textureRect,
+             float x, float y, float width, float height);
+
+    // Queues the layer's whole texture at (x, y), stretched to width x height
+    void add(std::size_t layer, float x, float y, float width, float height);
+
+    void draw(sf::RenderTarget& target) const;
+
+    // Number of draw calls the last draw() issued
+    int drawCalls() const { return lastDrawCalls; }
+
+private:
+    struct Layer {
+        const sf::Texture* texture;
+        sf::VertexArray vertices;
+    };
+    std::vector<Layer> layers;
+    mutable int lastDrawCalls = 0;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Lock-free single-producer / single-consumer ring buffer.
+// One thread calls push(), one other thread calls front()/pop(); neither ever blocks.
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Producer: copies value in; returns false if the queue is full
+    bool push(const T& value) {
+        const std::size_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail - headIndex.load(std::memory_order_acquire) == Capacity) return false;
+        slots[tail & (Capacity - 1)] = value;
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: oldest element, or nullptr if empty. Valid until pop().
+    T* front() {
+        const std::size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailIndex.load(std::memory_order_acquire)) return nullptr;
+        return &slots[head & (Capacity - 1)];
+    }
+
+    // Consumer: drops the oldest element (only after front() returned one)
+    void pop() {
+        headIndex.store(headIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool full() const {
+        return tailIndex.load(std::memory_order_acquire) - headIndex.load(std::memory_order_acquire) == Capacity;
+    }
+
+private:
+    std::array<T, Capacity> slots;
+    alignas(64) std::atomic<std::size_t> headIndex{0}; // next to read (consumer)
+    alignas(64) std::atomic<std::size_t> tailIndex{0}; // next to write (producer)
+};
@@ -0,0 +1,102 @@
+#include "texture_atlas.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+const unsigned ATLAS_PADDING = 2; // transparent gap between regions, so neighbours never bleed in
+
+// Bilinear resample, for pre-scaling sprites that are always drawn at one size
+sf::Image resample(const sf::Image& source, unsigned width, unsigned height) {
+    const sf::Vector2u size = source.getSize();
+    const sf::Uint8* pixels = source.getPixelsPtr();
+    std::vector<sf::Uint8> out(std::size_t(width) * height * 4);
+
+    for (unsigned y = 0; y < height; ++y) {
+        float sy = std::max(0.0f, (y + 0.5f) * size.y / height - 0.5f);
+        unsigned y0 = std::min(unsigned(sy), size.y - 1);
+        unsigned y1 = std::min(y0 + 1, size.y - 1);
+        float fy = sy - y0;
+        for (unsigned x = 0; x < width; ++x) {
+            float sx = std::max(0.0f, (x + 0.5f) * size.x / width - 0.5f);
+            unsigned x0 = std::min(unsigned(sx), size.x - 1);
+            unsigned x1 = std::min(x0 + 1, size.x - 1);
+            float fx = sx - x0;
+            for (unsigned c = 0; c < 4; ++c) {
+                float p00 = pixels[(y0 * size.x + x0) * 4 + c];
+                float p10 = pixels[(y0 * size.x + x1) * 4 + c];
+                float p01 = pixels[(y1 * size.x + x0) * 4 + c];
+                float p11 = pixels[(y1 * size.x + x1) * 4 + c];
+                float top = p00 + (p10 - p00) * fx;
+                float bottom = p01 + (p11 - p01) * fx;
+                out[(std::size_t(y) * width + x) * 4 + c] = sf::Uint8(top + (bottom - top) * fy + 0.5f);
+            }
+        }
+    }
+
+    sf::Image scaled;
+    scaled.create(width, height, out.data());
+    return scaled;
+}
+
+} // namespace
+
+void TextureAtlas::addImage(const std::string& name, const sf::Image& image, unsigned width, unsigned height) {
+    if (width > 0 && height > 0 && (width != image.getSize().x || height != image.getSize().y)) {
+        pending.push_back({name, resample(image, width, height)});
+    } else {
+        pending.push_back({name, image});
+    }
+}
+
+void TextureAtlas::pack() {
+    // Shelf packing: tallest first, left to right, new shelf when a row is full
+    std::vector<const Entry*> order;
+    unsigned atlasWidth = 0;
+    for (const auto& entry : pending) {
+        order.push_back(&entry);
+        atlasWidth = std::max(atlasWidth, entry.image.getSize().x + ATLAS_PADDING);
+    }
+    atlasWidth = std::max(atlasWidth, 1024u);
+    std::stable_sort(order.begin(), order.end(), [](const Entry* a, const Entry* b) {
+        return a->image.getSize().y > b->image.getSize().y;
+    });
+
+    unsigned x = 0, y = 0, shelfHeight = 0;
+    for (const Entry* entry : order) {
+        sf::Vector2u size = entry->image.getSize();
+        if (x + size.x > atlasWidth) {
+            x = 0;
+            y += shelfHeight + ATLAS_PADDING;
+            shelfHeight = 0;
+        }
+        rects[entry->name] = sf::IntRect(int(x), int(y), int(size.x), int(size.y));
+        x += size.x + ATLAS_PADDING;
+        shelfHeight = std::max(shelfHeight, size.y);
+    }
+    unsigned atlasHeight = y + shelfHeight;
+
+    if (atlasWidth > sf::Texture::getMaximumSize() || atlasHeight > sf::Texture::getMaximumSize()) {
+        throw std::runtime_error("Texture atlas is larger than the GPU's maximum texture size!");
+    }
+
+    sf::Image atlas;
+    atlas.create(atlasWidth, atlasHeight, sf::Color::Transparent);
+    for (const auto& entry : pending) {
+        const sf::IntRect& rect = rects[entry.name];
+        atlas.copy(entry.image, unsigned(rect.left), unsigned(rect.top));
+    }
+    if (!texture.loadFromImage(atlas)) {
+        throw std::runtime_error("Failed to create the texture atlas!");
+    }
+    pending.clear();
+}
+
+const sf::IntRect& TextureAtlas::getRect(const std::string& name) const {
+    auto it = rects.find(name);
+    if (it == rects.end()) {
+        throw std::runtime_error("No sprite named " + name + " in the texture atlas!");
+    }
+    return it->second;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Packs many small images into one texture, so sprites can be batched and drawn
+// without switching textures. Regions are looked up by name.
+//
+// Usage: add() every image, pack() once, then getRect() each name (at setup, not per frame).
+class TextureAtlas {
+public:
+    // Queues an image. If width/height are given, it is resampled to that size
+    // first, so the sprite can be drawn unscaled.
+    void addImage(const std::string& name, const sf::Image& image, unsigned width = 0, unsigned height = 0);
+
+    // Packs everything queued so far into the atlas texture
+    void pack();
+
+    const sf::Texture& getTexture() const { return texture; }
+    const sf::IntRect& getRect(const std::string& name) const;
+
+private:
+    struct Entry {
+        std::string name;
+        sf::Image image;
+    };
+    std::vector<Entry> pending;
+    std::unordered_map<std::string, sf::IntRect> rects;
+    sf::Texture texture;
+};
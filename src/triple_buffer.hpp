@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Lock-free triple buffer: one writer publishes whole values, one reader always
+// gets the newest complete one. Neither side ever waits for the other; values the
+// reader never picked up are simply overwritten.
+//
+// The writer fills back() and calls publish(); the reader calls acquire() and then
+// reads front(). The writer must overwrite every field it cares about, since the
+// slot it gets back after publishing holds an older value.
+template <typename T>
+class TripleBuffer {
+public:
+    T& back() { return slots[backIndex]; }
+
+    void publish() {
+        backIndex = middle.exchange(std::uint8_t(backIndex | DIRTY), std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Switches front() to the newest published value; false if nothing new was published
+    bool acquire() {
+        if ((middle.load(std::memory_order_relaxed) & DIRTY) == 0) return false;
+        frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    const T& front() const { return slots[frontIndex]; }
+
+private:
+    static constexpr std::uint8_t INDEX_MASK = 3;
+    static constexpr std::uint8_t DIRTY = 4; // middle holds a value the reader hasn't taken
+
+    std::array<T, 3> slots;
+    std::atomic<std::uint8_t> middle{1};
+    alignas(64) std::uint8_t backIndex = 0;  // writer only
+    alignas(64) std::uint8_t frontIndex = 2; // reader only
+};
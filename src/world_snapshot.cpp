@@ -0,0 +1,78 @@
+#include "world_snapshot.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// Copy-assignment only allocates when the source is bigger than the destination's
+// capacity. Matching the source's capacity (which only ever grows) makes that a
+// one-off per snapshot, even for vectors like the free lists that shrink and grow.
+template <typename T>
+void reserveLike(std::vector<T>& to, const std::vector<T>& from) {
+    if (to.capacity() < from.capacity()) to.reserve(from.capacity());
+}
+
+void reserveLike(EntityArrays& to, const EntityArrays& from) {
+    reserveLike(to.x, from.x);
+    reserveLike(to.y, from.y);
+    reserveLike(to.w, from.w);
+    reserveLike(to.h, from.h);
+    reserveLike(to.previousX, from.previousX);
+    reserveLike(to.type, from.type);
+    reserveLike(to.flags, from.flags);
+}
+
+void reserveLike(AxisIndex& to, const AxisIndex& from) {
+    if (to.capacity() < from.capacity()) to.reserve(from.capacity());
+}
+
+// A little over what a streamed level keeps alive at once, before --stress
+const std::size_t LEVEL_ENTITIES = 64;
+// Per entity: its array fields, a broadphase key (16 bytes, in a ring up to twice
+// the entity count) and a free slot
+const std::size_t BYTES_PER_ENTITY = 5 * sizeof(float) + 2 * sizeof(std::uint8_t) + 2 * 16 + sizeof(std::uint32_t);
+
+} // namespace
+
+std::size_t estimatedSnapshotBytes(const SimConfig& config) {
+    std::size_t entities = LEVEL_ENTITIES + 2 * std::size_t(std::max(0, config.stressEntities));
+    return sizeof(World) + entities * BYTES_PER_ENTITY;
+}
+
+void captureWorld(const World& world, WorldSnapshot& snapshot) {
+    World& to = snapshot.world;
+    reserveLike(to.platforms, world.platforms);
+    reserveLike(to.coins, world.coins);
+    reserveLike(to.obstacles, world.obstacles);
+    reserveLike(to.platformIndex, world.platformIndex);
+    reserveLike(to.coinIndex, world.coinIndex);
+    reserveLike(to.obstacleIndex, world.obstacleIndex);
+    reserveLike(to.freePlatforms, world.freePlatforms);
+    reserveLike(to.freeCoins, world.freeCoins);
+    reserveLike(to.freeObstacles, world.freeObstacles);
+    to = world;
+}
+
+void restoreWorld(World& world, const WorldSnapshot& snapshot) {
+    ChunkSource* chunkSource = world.chunkSource;
+    world = snapshot.world;
+    world.chunkSource = chunkSource;
+}
+
+RewindBuffer::RewindBuffer(std::size_t capacity) : slots(capacity) {}
+
+void RewindBuffer::push(const World& world) {
+    if (slots.empty()) return;
+    newest = count == 0 ? 0 : (newest + 1) % slots.size();
+    count = std::min(count + 1, slots.size());
+    captureWorld(world, slots[newest]);
+}
+
+std::size_t RewindBuffer::rewind(World& world, std::size_t ticks) {
+    if (count == 0) return 0;
+    std::size_t steps = std::min(ticks, count - 1);
+    newest = (newest + slots.size() - steps) % slots.size();
+    count -= steps;
+    restoreWorld(world, slots[newest]);
+    return steps;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "simulation.hpp"
+
+// Whole-world snapshots, for instant restart and rewind.
+//
+// A snapshot is everything step() reads or writes: clocks, player, lives and coins,
+// RNG state, entity arrays, broadphase indices and free slots. Capturing and restoring
+// are each one World copy. The entity arrays are vectors, so it is not a single memcpy,
+// but copy-assigning a vector into one that already has the capacity reuses its
+// storage: once a snapshot has held a world of this size, capturing into it and
+// restoring from it allocate nothing.
+struct WorldSnapshot {
+    World world;
+};
+
+void captureWorld(const World& world, WorldSnapshot& snapshot);
+// Roughly what one snapshot of a run with this config takes, for sizing a RewindBuffer
+std::size_t estimatedSnapshotBytes(const SimConfig& config);
+// Keeps world's chunkSource (the snapshot's may belong to someone else)
+void restoreWorld(World& world, const WorldSnapshot& snapshot);
+
+// The last `capacity` per-tick snapshots, oldest overwritten first
+class RewindBuffer {
+public:
+    explicit RewindBuffer(std::size_t capacity);
+
+    void clear() { count = 0; }
+    // Call after every tick (and once at the start of a run)
+    void push(const World& world);
+    std::size_t size() const { return count; }
+
+    // Puts world back `ticks` ticks before the newest snapshot (or to the oldest one
+    // kept) and drops the snapshots after it. Returns how many ticks it went back.
+    std::size_t rewind(World& world, std::size_t ticks);
+
+private:
+    std::vector<WorldSnapshot> slots;
+    std::size_t newest = 0;
+    std::size_t count = 0;
+};
@@ -0,0 +1,76 @@
+// Checks AxisIndex::query against a brute-force scan over the same entities.
+// Built and run by `make test`; no window needed. Exits with 1 if any check fails.
+
+#include <cstdio>
+#include <vector>
+
+#include "broadphase.hpp"
+#include "simulation.hpp"
+
+namespace {
+
+int failures = 0;
+
+// Every entity whose [x, x + w] overlaps [minX, maxX] must be visited by the query
+void expectQueryCovers(const char* name, const AxisIndex& index, const EntityArrays& e,
+                       float minX, float maxX, const char* context = "", long tick = 0) {
+    std::vector<bool> visited(e.size(), false);
+    index.query(minX, maxX, [&](std::size_t i) { visited[i] = true; });
+    for (std::size_t i = 0; i < e.size(); ++i) {
+        bool overlaps = e.x[i] <= maxX && e.x[i] + e.w[i] >= minX;
+        if (overlaps && !visited[i]) {
+            std::printf("FAIL %s%s tick %ld: entity %zu at x=%.2f w=%.0f not in query [%.2f, %.2f]\n",
+                        name, context, tick, i, e.x[i], e.w[i], minX, maxX);
+            ++failures;
+        }
+    }
+}
+
+// A slot reused by an entity wider than any at the last rebuild
+void testWiderReuse() {
+    EntityArrays e;
+    for (int i = 0; i < 8; ++i) e.add(i * 100.0f, 0.0f, 20.0f, 20.0f);
+    AxisIndex index;
+    index.rebuild(e.x, e.w);
+
+    // Entity 0 comes back 50 wide, starting 40 px left of the query range
+    float oldX = e.x[0];
+    e.x[0] = 460.0f;
+    e.w[0] = 50.0f;
+    index.relocate(0, oldX, e.x[0], e.w[0]);
+
+    expectQueryCovers("wider reuse", index, e, 500.0f, 540.0f);
+}
+
+// Streamed levels reuse free slots for whatever the next chunk spawns
+void testStreamedWorlds() {
+    for (unsigned int seed = 1; seed <= 50; ++seed) {
+        World world;
+        resetWorld(world, seed);
+        world.lives = 1 << 30;
+        SimInput input;
+        char context[32];
+        std::snprintf(context, sizeof(context), " (seed %u)", seed);
+        for (int t = 0; t < 3000; ++t) {
+            input.jump = input.jumpPressed = (world.tick % 90) == 0;
+            step(world, input);
+            float minX = world.player.x, maxX = world.player.x + FRAME_WIDTH;
+            expectQueryCovers("platforms", world.platformIndex, world.platforms, minX, maxX, context, world.tick);
+            expectQueryCovers("coins", world.coinIndex, world.coins, minX, maxX, context, world.tick);
+            expectQueryCovers("obstacles", world.obstacleIndex, world.obstacles, minX, maxX, context, world.tick);
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    testWiderReuse();
+    testStreamedWorlds();
+    if (failures > 0) {
+        std::printf("%d broadphase check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("broadphase: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,82 @@
+// Checks the SIMD overlapMask() against overlapMaskScalar() on random boxes.
+// Built and run by `make test`; no window needed. Exits with 1 if any check fails.
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "collision_kernel.hpp"
+
+namespace {
+
+int failures = 0;
+
+// Counts around the 4- and 8-wide SIMD steps and the 64-bit mask words
+const std::size_t COUNTS[] = {0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 63, 64, 65, 100, 127, 128, 129, 200};
+
+void expectSameMask(const char* name, float left, float top, float width, float height,
+                    const PackedBounds& bounds) {
+    std::vector<std::uint64_t> simd(3, ~std::uint64_t(0)), scalar; // stale words must be cleared
+    overlapMask(left, top, width, height, bounds, simd);
+    overlapMaskScalar(left, top, width, height, bounds, scalar);
+    if (simd != scalar) {
+        std::printf("FAIL %s: %zu boxes, masks differ\n", name, bounds.size());
+        ++failures;
+    }
+}
+
+// Random boxes on a coarse grid, so many of them share an edge with the player's box
+void testRandomBoxes() {
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> cell(0, 12), size(1, 4);
+    for (std::size_t count : COUNTS) {
+        for (int round = 0; round < 200; ++round) {
+            PackedBounds bounds;
+            for (std::size_t i = 0; i < count; ++i) {
+                bounds.push(std::uint32_t(i), cell(rng) * 10.0f, cell(rng) * 10.0f, size(rng) * 10.0f, size(rng) * 10.0f);
+            }
+            expectSameMask("random", cell(rng) * 10.0f, cell(rng) * 10.0f, size(rng) * 10.0f, size(rng) * 10.0f, bounds);
+        }
+    }
+}
+
+// Boxes that only touch the player's box don't overlap (strict <), ones a hair inside do
+void testTouchingEdges() {
+    const float left = 100.0f, top = 100.0f, width = 50.0f, height = 40.0f;
+    for (std::size_t count : COUNTS) {
+        PackedBounds bounds;
+        for (std::size_t i = 0; i < count; ++i) {
+            float inset = (i / 4) % 2 ? 0.5f : 0.0f;
+            switch (i % 4) {
+            case 0: bounds.push(std::uint32_t(i), left - 20.0f + inset, top, 20.0f, 10.0f); break;   // left edge
+            case 1: bounds.push(std::uint32_t(i), left + width - inset, top, 20.0f, 10.0f); break;   // right edge
+            case 2: bounds.push(std::uint32_t(i), left, top - 10.0f + inset, 20.0f, 10.0f); break;   // top edge
+            default: bounds.push(std::uint32_t(i), left, top + height - inset, 20.0f, 10.0f); break; // bottom edge
+            }
+        }
+        expectSameMask("touching", left, top, width, height, bounds);
+
+        std::vector<std::uint64_t> mask;
+        overlapMask(left, top, width, height, bounds, mask);
+        for (std::size_t i = 0; i < count; ++i) {
+            bool expected = (i / 4) % 2 != 0;
+            if (maskBit(mask, i) != expected) {
+                std::printf("FAIL touching: box %zu of %zu %s\n", i, count, expected ? "missed" : "counted as overlapping");
+                ++failures;
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    testRandomBoxes();
+    testTouchingEdges();
+    if (failures > 0) {
+        std::printf("%d collision kernel check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("collision kernel (%s): all checks passed\n", collisionKernelName());
+    return 0;
+}
@@ -0,0 +1,86 @@
+// Builds assets.pak from loose asset files.
+// Usage: pack_assets <output.pak> <asset directory> <file>...
+// Files are stored under their path relative to the asset directory.
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../src/asset_pack_format.hpp"
+
+namespace {
+
+template <typename T>
+void writeValue(std::ofstream& out, T value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " <output.pak> <asset directory> <file>...\n";
+        return 1;
+    }
+    const std::string outputPath = argv[1];
+    const std::string directory = argv[2];
+
+    struct Entry {
+        std::string name;
+        std::vector<char> bytes;
+        std::uint64_t offset = 0;
+    };
+    std::vector<Entry> entries;
+    for (int i = 3; i < argc; ++i) {
+        Entry entry;
+        entry.name = argv[i];
+        std::ifstream file(directory + "/" + entry.name, std::ios::binary);
+        if (!file) {
+            std::cerr << "Failed to open " << directory << "/" << entry.name << "\n";
+            return 1;
+        }
+        entry.bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        entries.push_back(std::move(entry));
+    }
+
+    // Lay out the data after the index, each file aligned
+    std::uint64_t indexEnd = sizeof(PACK_MAGIC) + 2 * sizeof(std::uint32_t);
+    for (const auto& entry : entries) {
+        indexEnd += 2 * sizeof(std::uint64_t) + sizeof(std::uint16_t) + entry.name.size();
+    }
+    std::uint64_t offset = indexEnd;
+    for (auto& entry : entries) {
+        offset = (offset + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT;
+        entry.offset = offset;
+        offset += entry.bytes.size();
+    }
+
+    std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Failed to create " << outputPath << "\n";
+        return 1;
+    }
+    out.write(PACK_MAGIC, sizeof(PACK_MAGIC));
+    writeValue<std::uint32_t>(out, PACK_VERSION);
+    writeValue<std::uint32_t>(out, std::uint32_t(entries.size()));
+    for (const auto& entry : entries) {
+        writeValue<std::uint64_t>(out, entry.offset);
+        writeValue<std::uint64_t>(out, entry.bytes.size());
+        writeValue<std::uint16_t>(out, std::uint16_t(entry.name.size()));
+        out.write(entry.name.data(), std::streamsize(entry.name.size()));
+    }
+    std::uint64_t position = indexEnd;
+    for (const auto& entry : entries) {
+        for (; position < entry.offset; ++position) out.put('\0');
+        out.write(entry.bytes.data(), std::streamsize(entry.bytes.size()));
+        position += entry.bytes.size();
+    }
+    if (!out) {
+        std::cerr << "Failed to write " << outputPath << "\n";
+        return 1;
+    }
+    std::cout << "Packed " << entries.size() << " files into " << outputPath << " (" << position << " bytes)\n";
+    return 0;
+}